@@ -78,23 +78,104 @@ extern "C" {
 extern unsigned int TM_TEST_DURATION_VALUE;
 void tm_initialize(void (*test_initialization_function)(void));
 int tm_thread_create(int thread_id, int priority, void (*entry_function)(void *, void *, void *));
-int tm_thread_resume(int thread_id);
-int tm_thread_suspend(int thread_id);
-void tm_thread_relinquish(void);
+int tm_thread_bind(int thread_id, int cpu);
+int tm_cpu_count(void);
 void tm_thread_sleep(int seconds);
+void tm_thread_sleep_ms(int milliseconds);
 void tm_thread_detach(void);
+void tm_thread_detach_wait(void);
+void tm_teardown(void);
 int tm_queue_create(int queue_id);
-int tm_queue_send(int queue_id, unsigned long *message_ptr);
-int tm_queue_receive(int queue_id, unsigned long *message_ptr);
 int tm_semaphore_create(int semaphore_id);
-int tm_semaphore_get(int semaphore_id);
-int tm_semaphore_put(int semaphore_id);
 int tm_mutex_create(int mutex_id);
 int tm_mutex_get(int mutex_id);
 int tm_mutex_put(int mutex_id);
 int tm_memory_pool_create(int pool_id);
+int tm_concurrent_running(void);
+
+/*
+ * The services below are called from inside the measured loops. The porting
+ * layer may provide them as static inline functions, see TM_PORTING_LAYER_INLINE.
+ */
+#if TM_PORTING_LAYER_INLINE
+#include "tm_porting_layer_rtthread.h"
+#else
+int tm_thread_resume(int thread_id);
+int tm_thread_suspend(int thread_id);
+void tm_thread_relinquish(void);
+int tm_queue_send(int queue_id, unsigned long *message_ptr);
+int tm_queue_receive(int queue_id, unsigned long *message_ptr);
+int tm_semaphore_get(int semaphore_id);
+int tm_semaphore_put(int semaphore_id);
 int tm_memory_pool_allocate(int pool_id, unsigned char **memory_ptr);
 int tm_memory_pool_deallocate(int pool_id, unsigned char *memory_ptr);
+int tm_calibration_stub(int id, void *arg);
+#endif
+
+/* Define the periodic sampler thread used by the measurement helpers.  */
+int tm_sampler_start(int priority, int period_ms, void (*sample_function)(void));
+void tm_sampler_stop(void);
+
+/* Define the free-running timestamp counter used to convert counts to time.  */
+unsigned long long tm_timestamp_get(void);
+unsigned long tm_timestamp_frequency(void);
+
+/* Define the test identifiers used by the measurement helpers.  */
+#define TM_BASIC_PROCESSING_ID                0
+#define TM_COOPERATIVE_SCHEDULING_ID          1
+#define TM_PREEMPTIVE_SCHEDULING_ID           2
+#define TM_INTERRUPT_PROCESSING_ID            3
+#define TM_INTERRUPT_PREEMPTION_PROCESSING_ID 4
+#define TM_MESSAGE_PROCESSING_ID              5
+#define TM_SYNCHRONIZATION_PROCESSING_ID      6
+#define TM_MEMORY_ALLOCATION_ID               7
+#define TM_COMPUTE_PROCESSING_ID              8
+#define TM_PARALLEL_PROCESSING_ID             9
+#define TM_MEMORY_BANDWIDTH_ID                10
+#define TM_FPU_SCHEDULING_ID                  11
+#define TM_QUEUE_COMPARISON_ID                12
+#define TM_POOL_COMPARISON_ID                 13
+#define TM_SEMAPHORE_COMPARISON_ID            14
+#define TM_ATOMIC_OPERATIONS_ID               15
+#define TM_SPINLOCK_ID                        16
+#define TM_IPI_LATENCY_ID                     17
+#define TM_THREAD_MIGRATION_ID                18
+#define TM_FALSE_SHARING_ID                   19
+
+/* Define the measurement helpers, see tm_measure.c.  */
+unsigned long tm_measure(int test_id, unsigned long long (*counter_read)(void));
+void tm_measure_report(int test_id);
+void tm_measure_report_frequency(void);
+void tm_measure_warmup(int test_id, unsigned long milliseconds);
+void tm_measure_fail(int test_id, const char *reason);
+unsigned long long tm_measure_cost(int test_id);
+unsigned long long tm_measure_throughput(int test_id);
+const char *tm_measure_test_name(int test_id);
+const char *tm_measure_format(char *buffer, int size, unsigned long long value);
+const char *tm_measure_format_count(char *buffer, int size, unsigned long long value);
+void tm_measure_status(void);
+void tm_measure_summary(void);
+void tm_calibrate(int test_id, void (*skeleton)(unsigned long iterations));
+void tm_calibration_main(void);
+
+/* Define the kernels of the basic processing test, see tm_basic_processing_test.c.  */
+#define TM_BASIC_KERNEL_INTEGER               0
+#define TM_BASIC_KERNEL_CRC32                 1
+#define TM_BASIC_KERNEL_MEMCPY                2
+#define TM_BASIC_KERNEL_BRANCHY               3
+#define TM_BASIC_KERNEL_NUM                   4
+
+void tm_basic_processing_fill(unsigned long *data, unsigned long words);
+unsigned long tm_basic_processing_kernel(int kernel, unsigned long *data, unsigned long words, unsigned long seed);
+
+/* Define the checksum a thread publishes after each pass, two of them indexed by the pass number modulo 2.  */
+typedef struct tm_basic_processing_result {
+    volatile unsigned long pass;
+    volatile unsigned long checksum;
+} tm_basic_processing_result_t;
+
+int tm_basic_processing_verify(TM_COUNTER *counter, tm_basic_processing_result_t *result,
+                               unsigned long *data, unsigned long words, unsigned long *checksum);
 
 /* Testcases */
 int tm_basic_processing_main(void);
@@ -105,6 +186,27 @@ int tm_interrupt_preemption_processing_main(void);
 int tm_message_processing_main(void);
 int tm_synchronization_processing_main(void);
 int tm_memory_allocation_main(void);
+int tm_compute_processing_main(void);
+int tm_parallel_processing_main(void);
+int tm_memory_bandwidth_main(void);
+int tm_fpu_scheduling_main(void);
+int tm_queue_comparison_main(void);
+int tm_pool_comparison_main(void);
+int tm_semaphore_comparison_main(void);
+int tm_atomic_operations_main(void);
+int tm_spinlock_main(void);
+int tm_ipi_latency_main(void);
+int tm_thread_migration_main(void);
+int tm_false_sharing_main(void);
+
+/* Loop skeletons of the testcases, used by the calibration phase */
+void tm_cooperative_scheduling_calibrate(void);
+void tm_preemptive_scheduling_calibrate(void);
+void tm_interrupt_processing_calibrate(void);
+void tm_interrupt_preemption_processing_calibrate(void);
+void tm_message_processing_calibrate(void);
+void tm_synchronization_processing_calibrate(void);
+void tm_memory_allocation_calibrate(void);
 
 /*
  * Determine if a C++ compiler is being used.  If so, complete the standard
@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Atomic operations test. Runs the load, store, add, exchange and
+ * compare-exchange operations of the rt_atomic API and full, acquire and
+ * release fences in batches of TM_ATOMIC_BATCH: in one thread, then on SMP
+ * builds with two cores or more in one thread per core, all on one shared
+ * cache line and each on a private one. Each operation and mode runs for one
+ * test period. The report shows the timestamp counts per operation of
+ * each thread; the value left by the add operation is checked against the
+ * number of adds counted, so that a lost update fails the test.
+ */
+
+#include "tm_api.h"
+#include <stdatomic.h>
+
+#define TM_ATOMIC_BATCH 64
+
+/* Define the modes of the test.  */
+#define TM_ATOMIC_ALONE   0
+#define TM_ATOMIC_SHARED  1
+#define TM_ATOMIC_PRIVATE 2
+#define TM_ATOMIC_MODES   3
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_ATOMIC_MAX_THREADS 8
+
+TM_COUNTER tm_atomic_operations_counter[TM_ATOMIC_MAX_THREADS];
+
+/* Define the operands, one per cache line; the shared mode only uses the first one.  */
+
+typedef struct tm_atomic_slot {
+    rt_align(TM_CACHE_LINE_SIZE) rt_atomic_t value;
+} tm_atomic_slot_t;
+
+static tm_atomic_slot_t tm_atomic_slot[TM_ATOMIC_MAX_THREADS];
+
+/* Define the results of the loads of each thread, so that they are not optimized away.  */
+static volatile rt_atomic_t tm_atomic_sink[TM_ATOMIC_MAX_THREADS];
+
+/* Define the operations of the test, each runs a batch on the specified operand.  */
+
+static void tm_atomic_load(int id, volatile rt_atomic_t *value)
+{
+    rt_atomic_t sum = 0;
+    int i;
+
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        sum += rt_atomic_load(value);
+    }
+    tm_atomic_sink[id] = sum;
+}
+
+static void tm_atomic_store(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        rt_atomic_store(value, i);
+    }
+}
+
+static void tm_atomic_add(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        rt_atomic_add(value, 1);
+    }
+}
+
+static void tm_atomic_exchange(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        rt_atomic_exchange(value, i);
+    }
+}
+
+/*
+ * Count the attempts. A successful compare-exchange expects its own value
+ * next, a failed one retries with the value it read, which only happens
+ * when another core changed the operand.
+ */
+static void tm_atomic_compare_exchange(int id, volatile rt_atomic_t *value)
+{
+    rt_atomic_t expected = rt_atomic_load(value);
+    int i;
+
+    (void)id;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        if (rt_atomic_compare_exchange_strong(value, &expected, expected + 1)) {
+            expected++;
+        }
+    }
+}
+
+static void tm_atomic_full_fence(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    (void)value;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+static void tm_atomic_acquire_fence(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    (void)value;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        atomic_thread_fence(memory_order_acquire);
+    }
+}
+
+static void tm_atomic_release_fence(int id, volatile rt_atomic_t *value)
+{
+    int i;
+
+    (void)id;
+    (void)value;
+    for (i = 0; i < TM_ATOMIC_BATCH; i++) {
+        atomic_thread_fence(memory_order_release);
+    }
+}
+
+typedef struct tm_atomic_operation {
+    const char *name;
+    void (*run)(int id, volatile rt_atomic_t *value);
+} tm_atomic_operation_t;
+
+#define TM_ATOMIC_ADD 2
+
+static const tm_atomic_operation_t tm_atomic_operation[] = {
+    { "load",             tm_atomic_load },
+    { "store",            tm_atomic_store },
+    { "add",              tm_atomic_add },
+    { "exchange",         tm_atomic_exchange },
+    { "compare-exchange", tm_atomic_compare_exchange },
+    { "full fence",       tm_atomic_full_fence },
+    { "acquire fence",    tm_atomic_acquire_fence },
+    { "release fence",    tm_atomic_release_fence },
+};
+
+#define TM_ATOMIC_OPERATION_NUM (sizeof(tm_atomic_operation) / sizeof(tm_atomic_operation[0]))
+
+/* Define the operation and the mode of the current variant.  */
+
+static const tm_atomic_operation_t *volatile tm_atomic_current;
+static volatile int tm_atomic_mode;
+static int tm_atomic_threads;
+
+/* Define the results of each variant.  */
+static unsigned long tm_atomic_ops[TM_ATOMIC_MODES][TM_ATOMIC_OPERATION_NUM];
+static unsigned long long tm_atomic_cost[TM_ATOMIC_MODES][TM_ATOMIC_OPERATION_NUM];
+static int tm_atomic_status[TM_ATOMIC_MODES][TM_ATOMIC_OPERATION_NUM];
+static int tm_atomic_mode_threads[TM_ATOMIC_MODES];
+
+/* Define the test thread prototypes.  */
+
+void tm_atomic_operations_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_atomic_operations_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_atomic_operations_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_atomic_operations_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_atomic_operations_initialize);
+
+    return 0;
+}
+
+/* Define the atomic operations thread, one per core.  */
+void tm_atomic_operations_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    const tm_atomic_operation_t *operation = tm_atomic_current;
+    volatile rt_atomic_t *value = &tm_atomic_slot[(tm_atomic_mode == TM_ATOMIC_SHARED) ? 0 : id].value;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Run a batch of the operation.  */
+        operation->run(id, value);
+
+        /* Increment the number of batches of the thread.  */
+        tm_counter_increment(&tm_atomic_operations_counter[id]);
+    }
+}
+
+/* Define the atomic operations counter read function, the total of all threads.  */
+static unsigned long long tm_atomic_operations_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_atomic_threads; i++) {
+        total += tm_counter_read(&tm_atomic_operations_counter[i]);
+    }
+
+    return total;
+}
+
+/*
+ * Check the operands after the adds of the specified threads, each counted
+ * batch must be in them and at most one more uncounted batch per thread.
+ * The operands are as wide as rt_atomic_t and wrap on long periods, so the
+ * adds are compared modulo that width.
+ * Returns TM_SUCCESS if no add was lost, TM_ERROR otherwise.
+ */
+static int tm_atomic_operations_check(int mode, int threads, const unsigned long long *start)
+{
+    unsigned long long batches;
+    rt_ubase_t value;
+    int operands = (mode == TM_ATOMIC_SHARED) ? 1 : threads;
+    int i;
+
+    batches = 0;
+    for (i = 0; i < threads; i++) {
+        batches += tm_counter_read(&tm_atomic_operations_counter[i]) - start[i];
+    }
+
+    value = 0;
+    for (i = 0; i < operands; i++) {
+        value += (rt_ubase_t)rt_atomic_load(&tm_atomic_slot[i].value);
+    }
+
+    /* Subtract the counted batches, at most one uncounted batch per thread may be left.  */
+    value -= (rt_ubase_t)(batches * TM_ATOMIC_BATCH);
+
+    return (value <= (rt_ubase_t)threads * TM_ATOMIC_BATCH) ? TM_SUCCESS : TM_ERROR;
+}
+
+/* Measure one operation in one mode with the specified number of threads.  */
+static void tm_atomic_operations_variant(int mode, unsigned int index, int threads)
+{
+    unsigned long long start[TM_ATOMIC_MAX_THREADS];
+    int i;
+
+    /* Clear the operands and create one thread per core at priority 10, bound to its core.  */
+    tm_atomic_current = &tm_atomic_operation[index];
+    tm_atomic_mode = mode;
+    tm_atomic_threads = threads;
+    for (i = 0; i < TM_ATOMIC_MAX_THREADS; i++) {
+        rt_atomic_store(&tm_atomic_slot[i].value, 0);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_atomic_operations_thread_entry);
+        tm_thread_bind(i, i);
+        start[i] = tm_counter_read(&tm_atomic_operations_counter[i]);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_resume(i);
+    }
+
+    /* Measure the batches for one period, then stop the threads.  */
+    tm_atomic_ops[mode][index] = tm_measure(TM_ATOMIC_OPERATIONS_ID, tm_atomic_operations_counter_read);
+    tm_atomic_cost[mode][index] = tm_measure_cost(TM_ATOMIC_OPERATIONS_ID);
+    tm_thread_detach_wait();
+    tm_atomic_status[mode][index] = (tm_atomic_ops[mode][index] != 0) ? TM_SUCCESS : TM_ERROR;
+    if ((index == TM_ATOMIC_ADD) && (tm_atomic_operations_check(mode, threads, start) != TM_SUCCESS)) {
+        tm_atomic_status[mode][index] = TM_ERROR;
+    }
+}
+
+/* Define the atomic operations test initialization.  */
+
+void tm_atomic_operations_initialize(void)
+{
+    int cores = tm_cpu_count();
+    unsigned int index;
+    int mode;
+
+    if (cores > TM_ATOMIC_MAX_THREADS) {
+        cores = TM_ATOMIC_MAX_THREADS;
+    }
+
+    /* Contend across the cores only if there are two or more.  */
+    tm_atomic_mode_threads[TM_ATOMIC_ALONE] = 1;
+    tm_atomic_mode_threads[TM_ATOMIC_SHARED] = (cores > 1) ? cores : 0;
+    tm_atomic_mode_threads[TM_ATOMIC_PRIVATE] = (cores > 1) ? cores : 0;
+
+    for (mode = 0; mode < TM_ATOMIC_MODES; mode++) {
+        for (index = 0; (index < TM_ATOMIC_OPERATION_NUM) && tm_atomic_mode_threads[mode]; index++) {
+            tm_atomic_operations_variant(mode, index, tm_atomic_mode_threads[mode]);
+        }
+    }
+
+    tm_atomic_operations_thread_report();
+}
+
+/* Format the timestamp counts per operation of a thread, x100, of the specified variant.  */
+static const char *tm_atomic_operations_format(char *buffer, int size, int mode, unsigned int index)
+{
+    unsigned long long cost;
+
+    if (tm_atomic_mode_threads[mode] == 0) {
+        return "-";
+    }
+    if (tm_atomic_status[mode][index] != TM_SUCCESS) {
+        return "FAILED";
+    }
+
+    cost = tm_atomic_cost[mode][index] * tm_atomic_mode_threads[mode] / TM_ATOMIC_BATCH;
+    return tm_measure_format(buffer, size, cost);
+}
+
+/* Define the atomic operations reporting function.  */
+void tm_atomic_operations_thread_report(void)
+{
+
+    unsigned long period_counter;
+    char alone_buffer[16];
+    char shared_buffer[16];
+    char private_buffer[16];
+    unsigned int periods;
+    unsigned int index;
+    int failed;
+    int mode;
+
+    /* Total the operations of all variants.  */
+    period_counter = 0;
+    periods = 0;
+    failed = 0;
+    for (mode = 0; mode < TM_ATOMIC_MODES; mode++) {
+        for (index = 0; (index < TM_ATOMIC_OPERATION_NUM) && tm_atomic_mode_threads[mode]; index++) {
+            period_counter += tm_atomic_ops[mode][index] * TM_ATOMIC_BATCH;
+            failed |= (tm_atomic_status[mode][index] != TM_SUCCESS);
+            periods++;
+        }
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Atomic operations thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_ATOMIC_OPERATIONS_ID, "atomic add lost an update");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Atomic Operations Test", period_counter,
+           TM_TEST_DURATION_VALUE * periods, rt_tick_get());
+    tm_measure_report_frequency();
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  counts/op", "alone", "shared", "private");
+    for (index = 0; index < TM_ATOMIC_OPERATION_NUM; index++) {
+        printf("|   %-38s | %-10s | %-10s | %-10s |\n", tm_atomic_operation[index].name,
+               tm_atomic_operations_format(alone_buffer, sizeof(alone_buffer), TM_ATOMIC_ALONE, index),
+               tm_atomic_operations_format(shared_buffer, sizeof(shared_buffer), TM_ATOMIC_SHARED, index),
+               tm_atomic_operations_format(private_buffer, sizeof(private_buffer), TM_ATOMIC_PRIVATE, index));
+    }
+    tm_measure_report(TM_ATOMIC_OPERATIONS_ID);
+
+    tm_teardown();
+}
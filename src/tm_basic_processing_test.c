@@ -41,10 +41,11 @@
 /*                                                                        */
 /**************************************************************************/
 #include "tm_api.h"
+#include <string.h>
 
 /* Define the counters used in the demo application...  */
 
-volatile unsigned long tm_basic_processing_counter;
+TM_COUNTER tm_basic_processing_counter;
 
 /* Define the counters used in the demo application...  */
 
@@ -56,9 +57,47 @@ unsigned int TM_TEST_DURATION_VALUE;
  * test array to eat up processing bandwidth. The idea is that
  * all RTOSes should produce the same metric here if everything
  * else is equal, e.g. processor speed, memory speed, etc.
+ *
+ * The array is not volatile, so the work depends on the CPU and not on
+ * how the compiler treats volatile. Instead each pass returns a checksum,
+ * which is published with its pass number and verified by the reporter.
  */
 
-volatile unsigned long tm_basic_processing_array[1024];
+#define TM_BASIC_PROCESSING_WORDS 1024
+
+unsigned long tm_basic_processing_array[TM_BASIC_PROCESSING_WORDS];
+
+/* Define the checksum of the last passes, indexed by the pass number modulo 2.  */
+static tm_basic_processing_result_t tm_basic_processing_result[2];
+
+/* Define the working set of the test thread, the test array unless sweeping.  */
+static unsigned long *tm_basic_processing_data = tm_basic_processing_array;
+static unsigned long tm_basic_processing_words = TM_BASIC_PROCESSING_WORDS;
+
+#if TM_BASIC_SWEEP_ENABLE
+/* Define the results of the working set sweep.  */
+#define TM_BASIC_SWEEP_MAX_SIZES 32
+
+static unsigned long tm_basic_sweep_bytes[TM_BASIC_SWEEP_MAX_SIZES];
+static unsigned long tm_basic_sweep_ops[TM_BASIC_SWEEP_MAX_SIZES];
+static int tm_basic_sweep_status[TM_BASIC_SWEEP_MAX_SIZES];
+static int tm_basic_sweep_count;
+
+#if TM_BASIC_SWEEP_PLACEMENT == 1
+static unsigned long tm_basic_sweep_buffer[TM_BASIC_SWEEP_MAX_BYTES / sizeof(unsigned long)];
+#elif TM_BASIC_SWEEP_PLACEMENT == 2
+rt_section(TM_BASIC_SWEEP_SECTION) static unsigned long tm_basic_sweep_buffer[TM_BASIC_SWEEP_MAX_BYTES / sizeof(unsigned long)];
+#endif
+
+static const char *tm_basic_sweep_placement[3] = {
+    "heap", "static", TM_BASIC_SWEEP_SECTION,
+};
+#endif
+
+/* Define the name of each kernel.  */
+static const char *tm_basic_processing_kernel_name[TM_BASIC_KERNEL_NUM] = {
+    "integer", "crc32", "memcpy", "branchy",
+};
 
 /* Define the test thread prototypes.  */
 
@@ -72,6 +111,12 @@ void tm_basic_processing_thread_report(void);
 
 void tm_basic_processing_initialize(void);
 
+#if TM_BASIC_SWEEP_ENABLE
+/* Define the working set sweep prototype.  */
+
+static void tm_basic_processing_sweep(void);
+#endif
+
 /* Define main entry point.  */
 
 int tm_basic_processing_main(void)
@@ -86,6 +131,16 @@ int tm_basic_processing_main(void)
 
 void tm_basic_processing_initialize(void)
 {
+#if TM_BASIC_SWEEP_ENABLE
+    /* Sweep the working set first, the standard run below is kept as the test result.  */
+    tm_basic_processing_sweep();
+#endif
+
+    /* Initialize the test array.   */
+    tm_basic_processing_data = tm_basic_processing_array;
+    tm_basic_processing_words = TM_BASIC_PROCESSING_WORDS;
+    tm_basic_processing_fill(tm_basic_processing_data, tm_basic_processing_words);
+
     /* Create thread 0 at priority 10.  */
     tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_basic_processing_thread_0_entry);
 
@@ -95,77 +150,302 @@ void tm_basic_processing_initialize(void)
     tm_basic_processing_thread_report();
 }
 
+/* Fill the array with a fixed pseudo-random pattern.  */
+void tm_basic_processing_fill(unsigned long *data, unsigned long words)
+{
+    unsigned long state = 0x12345678;
+    unsigned long i;
+
+    for (i = 0; i < words; i++) {
+
+        /* Advance a 32-bit xorshift generator.  */
+        state ^= (state << 13) & 0xFFFFFFFFUL;
+        state ^= state >> 17;
+        state ^= (state << 5) & 0xFFFFFFFFUL;
+        data[i] = state;
+    }
+}
+
+/* Define the CRC32 (reflected 0xEDB88320) table, one entry per nibble.  */
+static const unsigned long tm_basic_processing_crc32_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/*
+ * Run one pass of the specified kernel over the array and return its
+ * checksum. The result only depends on the kernel, the array contents set by
+ * tm_basic_processing_fill() and the seed, so it can be computed again to
+ * verify it. The memcpy kernel overwrites the second half of the array.
+ */
+unsigned long tm_basic_processing_kernel(int kernel, unsigned long *data, unsigned long words, unsigned long seed)
+{
+    unsigned long checksum = seed;
+    unsigned long value;
+    unsigned long half;
+    unsigned long i;
+    unsigned int b;
+    int state;
+
+    switch (kernel) {
+
+    case TM_BASIC_KERNEL_CRC32:
+
+        /* Compute the CRC32 of the array, starting from the seed.  */
+        checksum = ~seed & 0xFFFFFFFFUL;
+        for (i = 0; i < words; i++) {
+            value = data[i];
+            for (b = 0; b < sizeof(unsigned long); b++) {
+                checksum = tm_basic_processing_crc32_table[(checksum ^ value) & 0xF] ^ (checksum >> 4);
+                checksum = tm_basic_processing_crc32_table[(checksum ^ (value >> 4)) & 0xF] ^ (checksum >> 4);
+                value >>= 8;
+            }
+        }
+        checksum = ~checksum & 0xFFFFFFFFUL;
+        break;
+
+    case TM_BASIC_KERNEL_MEMCPY:
+
+        /* Copy the first half of the array to the second half and sample the copy.  */
+        half = words / 2;
+        memcpy(&data[half], &data[0], half * sizeof(unsigned long));
+        for (i = half; i < words; i += 16) {
+            checksum = (checksum * 31) + data[i];
+        }
+        break;
+
+    case TM_BASIC_KERNEL_BRANCHY:
+
+        /* Walk a state machine driven by the low bits of each word.  */
+        state = (int)(seed & 3);
+        for (i = 0; i < words; i++) {
+            value = data[i];
+            switch (state) {
+            case 0:
+                if (value & 1) {
+                    checksum += value;
+                    state = 1;
+                } else {
+                    state = 2;
+                }
+                break;
+            case 1:
+                if (value & 2) {
+                    checksum ^= value;
+                    state = 3;
+                } else {
+                    checksum -= i;
+                    state = 0;
+                }
+                break;
+            case 2:
+                if ((value & 6) == 6) {
+                    checksum = (checksum << 1) | (checksum >> (sizeof(unsigned long) * 8 - 1));
+                    state = 0;
+                } else {
+                    checksum += i;
+                    state = 3;
+                }
+                break;
+            default:
+                checksum ^= value >> 3;
+                state = (int)(value >> 8) & 3;
+                break;
+            }
+        }
+        break;
+
+    default:
+
+        /*
+         * Add each entry to the running value and xor the result with the
+         * previous value...   just to eat up some time.
+         */
+        for (i = 0; i < words; i++) {
+            checksum = (checksum + data[i]) ^ (checksum >> 3);
+        }
+        break;
+    }
+
+    return checksum;
+}
+
 /* Define the basic processing thread.  */
 void tm_basic_processing_thread_0_entry(void *p1, void *p2, void *p3)
 {
-    int i;
+    tm_basic_processing_result_t *result;
+    unsigned long checksum;
+    unsigned long pass;
 
     (void)p1;
     (void)p2;
     (void)p3;
 
-    /* Initialize the test array.   */
-    for (i = 0; i < 1024; i++) {
+    /* Number the passes after those counted by earlier threads of the test.  */
+    pass = (unsigned long)tm_counter_read(&tm_basic_processing_counter);
+    while (1) {
+
+        /* Run one pass of the kernel over the basic processing array.  */
+        checksum = tm_basic_processing_kernel(TM_BASIC_KERNEL, tm_basic_processing_data,
+                                              tm_basic_processing_words, pass);
+
+        /* Publish the checksum before the pass is counted.  */
+        result = &tm_basic_processing_result[pass & 1];
+        result->pass = pass;
+        result->checksum = checksum;
+        pass++;
 
-        /* Clear the basic processing array.  */
-        tm_basic_processing_array[i] = 0;
+        /* Increment the basic processing counter.  */
+        tm_counter_increment(&tm_basic_processing_counter);
     }
+}
 
-    while (1) {
+/* Define the basic processing counter read function.  */
+static unsigned long long tm_basic_processing_counter_read(void)
+{
+    return tm_counter_read(&tm_basic_processing_counter);
+}
 
-        /*
-         * Loop through the basic processing array, add the previous
-         * contents with the contents of the tm_basic_processing_counter
-         * and xor the result with the previous value...   just to eat
-         * up some time.
-         */
+/*
+ * Verify the checksum of the last pass counted by the specified counter by
+ * running the kernel again over the data of the thread. As soon as the
+ * thread counts a pass it starts writing the other result, which holds the
+ * pass before, so retry until the counter is unchanged across the read.
+ * Returns TM_SUCCESS if the checksum matches, TM_ERROR otherwise.
+ */
+int tm_basic_processing_verify(TM_COUNTER *counter, tm_basic_processing_result_t *result,
+                               unsigned long *data, unsigned long words, unsigned long *checksum)
+{
+    unsigned long long count;
+    unsigned long pass;
+
+    do {
+        count = tm_counter_read(counter);
+        if (count == 0) {
+            return TM_ERROR;
+        }
+
+        pass = result[(unsigned long)(count - 1) & 1].pass;
+        *checksum = result[(unsigned long)(count - 1) & 1].checksum;
+    } while (tm_counter_read(counter) != count);
+
+    if (pass != (unsigned long)(count - 1)) {
+        return TM_ERROR;
+    }
 
-        for (i = 0; i < 1024; i++) {
+    return (*checksum == tm_basic_processing_kernel(TM_BASIC_KERNEL, data, words, pass)) ? TM_SUCCESS : TM_ERROR;
+}
 
-            /* Update each array entry.  */
-            tm_basic_processing_array[i] =
-                (tm_basic_processing_array[i] + tm_basic_processing_counter) ^
-                tm_basic_processing_array[i];
+#if TM_BASIC_SWEEP_ENABLE
+/* Measure the test thread over each working set size of the sweep.  */
+static void tm_basic_processing_sweep(void)
+{
+    unsigned long bytes;
+    unsigned long checksum;
+
+    tm_basic_sweep_count = 0;
+    for (bytes = TM_BASIC_SWEEP_MIN_BYTES;
+         (bytes <= TM_BASIC_SWEEP_MAX_BYTES) && (tm_basic_sweep_count < TM_BASIC_SWEEP_MAX_SIZES);
+         bytes *= 2) {
+
+        /* Place the working set.  */
+#if TM_BASIC_SWEEP_PLACEMENT == 0
+        tm_basic_processing_data = (unsigned long *)rt_malloc_align(bytes, TM_CACHE_LINE_SIZE);
+        if (tm_basic_processing_data == RT_NULL) {
+            break;
         }
+#else
+        tm_basic_processing_data = tm_basic_sweep_buffer;
+#endif
+        tm_basic_processing_words = bytes / sizeof(unsigned long);
+        tm_basic_processing_fill(tm_basic_processing_data, tm_basic_processing_words);
+
+        /* Run the test thread over it for one period.  */
+        tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_basic_processing_thread_0_entry);
+        tm_thread_resume(0);
+
+        tm_basic_sweep_bytes[tm_basic_sweep_count] = bytes;
+        tm_basic_sweep_ops[tm_basic_sweep_count] = tm_measure(TM_BASIC_PROCESSING_ID, tm_basic_processing_counter_read);
+        tm_basic_sweep_status[tm_basic_sweep_count] =
+            tm_basic_processing_verify(&tm_basic_processing_counter, tm_basic_processing_result,
+                                       tm_basic_processing_data, tm_basic_processing_words, &checksum);
+        tm_basic_sweep_count++;
 
-        /* Increment the basic processing counter.  */
-        tm_basic_processing_counter++;
+        tm_thread_detach();
+#if TM_BASIC_SWEEP_PLACEMENT == 0
+        rt_free_align(tm_basic_processing_data);
+#endif
     }
 }
 
+/* Show the passes and the bandwidth over the working set of each size.  */
+static void tm_basic_processing_sweep_report(void)
+{
+    unsigned long long rate;
+    char buffer[16];
+    int i;
+
+    printf("| %-29s %-10s | %-10s | %-10s | %-10s |\n", "  working set sweep:",
+           tm_basic_sweep_placement[TM_BASIC_SWEEP_PLACEMENT], "KiB", "passes", "MB/s");
+    for (i = 0; i < tm_basic_sweep_count; i++) {
+
+        /* Compute the MB/s, x100.  */
+        rate = (unsigned long long)tm_basic_sweep_ops[i] * tm_basic_sweep_bytes[i] / (TM_TEST_DURATION_VALUE * 10000ULL);
+
+        printf("| %-40s | %-10lu | %-10lu | %-10s |\n", "", tm_basic_sweep_bytes[i] / 1024, tm_basic_sweep_ops[i],
+               (tm_basic_sweep_status[i] == TM_SUCCESS) ? tm_measure_format(buffer, sizeof(buffer), rate) : "FAILED");
+    }
+}
+#endif
+
 /* Define the basic processing reporting function.  */
 void tm_basic_processing_thread_report(void)
 {
 
-    unsigned long last_counter;
+    unsigned long period_counter;
     unsigned long relative_time;
-
-    /* Initialize the last counter.  */
-    last_counter = 0;
+    unsigned long checksum;
+    int status;
 
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_counter = tm_measure(TM_BASIC_PROCESSING_ID, tm_basic_processing_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* See if there are any errors.  */
-        if (tm_basic_processing_counter == last_counter) {
+        if (period_counter == 0) {
 
             printf("ERROR: Invalid counter value(s). Basic processing thread died!\n");
         }
 
-        /* Show the time period total.  */
-        printf("| %-40s | %-10lu | %-10lu | %-10lu |\n", "Basic Single Thread Processing Test", tm_basic_processing_counter - last_counter, relative_time, rt_tick_get());
-        /* Save the last counter.  */
-        last_counter = tm_basic_processing_counter;
+        /* Check the published checksum of the kernel.  */
+        checksum = 0;
+        status = tm_basic_processing_verify(&tm_basic_processing_counter, tm_basic_processing_result,
+                                            tm_basic_processing_data, tm_basic_processing_words, &checksum);
+        if (status != TM_SUCCESS) {
 
-        tm_thread_detach();
+            tm_measure_fail(TM_BASIC_PROCESSING_ID, "kernel checksum mismatch");
+        }
+
+        /* Show the time period total.  */
+        printf("| %-40s | %-10lu | %-10lu | %-10lu |\n", "Basic Single Thread Processing Test", period_counter, relative_time, rt_tick_get());
+        printf("| %-40s | %-10s | %08lx   | %-10s |\n", "  kernel, checksum, verified",
+               tm_basic_processing_kernel_name[TM_BASIC_KERNEL], checksum & 0xFFFFFFFFUL,
+               (status == TM_SUCCESS) ? "yes" : "NO");
+#if TM_BASIC_SWEEP_ENABLE
+        tm_basic_processing_sweep_report();
+#endif
+        tm_measure_report(TM_BASIC_PROCESSING_ID);
+
+        tm_teardown();
         return;
     }
 }
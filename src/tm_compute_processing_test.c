@@ -0,0 +1,610 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Compute processing test. Runs DSP style kernels, a q15 and a float FIR
+ * filter, a float FFT and a float matrix multiply, each doing 4096
+ * multiply-accumulates per pass. Every kernel has a scalar version and, when
+ * the compiler targets Arm Helium, Arm NEON or the RISC-V V extension, a
+ * vectorized version. The output of each version is checked against a scalar
+ * reference and its throughput is reported in MMAC/s.
+ */
+
+#include "tm_api.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+#include <arm_mve.h>
+#define TM_COMPUTE_SIMD      "helium"
+#define TM_COMPUTE_SIMD_MVE  1
+#define tm_compute_mla_f32   vfmaq_f32
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TM_COMPUTE_SIMD      "neon"
+#define TM_COMPUTE_SIMD_NEON 1
+#define tm_compute_mla_f32   vmlaq_f32
+#elif defined(__riscv_vector)
+#include <riscv_vector.h>
+#define TM_COMPUTE_SIMD      "rvv"
+#define TM_COMPUTE_SIMD_RVV  1
+#endif
+
+/* Define the sizes of the kernels, each does TM_COMPUTE_MACS multiply-accumulates per pass.  */
+#define TM_COMPUTE_FIR_TAPS  32
+#define TM_COMPUTE_FIR_BLOCK 128
+#define TM_COMPUTE_FFT_SIZE  256
+#define TM_COMPUTE_FFT_LOG2  8
+#define TM_COMPUTE_MAT_SIZE  16
+#define TM_COMPUTE_MACS      4096
+
+TM_COUNTER tm_compute_processing_counter;
+
+/* Define the input data of the kernels.  */
+
+static short tm_compute_fir_q15_input[TM_COMPUTE_FIR_BLOCK + TM_COMPUTE_FIR_TAPS];
+static short tm_compute_fir_q15_coeff[TM_COMPUTE_FIR_TAPS];
+static float tm_compute_fir_f32_input[TM_COMPUTE_FIR_BLOCK + TM_COMPUTE_FIR_TAPS];
+static float tm_compute_fir_f32_coeff[TM_COMPUTE_FIR_TAPS];
+static float tm_compute_fft_input[TM_COMPUTE_FFT_SIZE];
+static float tm_compute_fft_cos[TM_COMPUTE_FFT_SIZE / 2];
+static float tm_compute_fft_sin[TM_COMPUTE_FFT_SIZE / 2];
+static float tm_compute_mat_a[TM_COMPUTE_MAT_SIZE][TM_COMPUTE_MAT_SIZE];
+static float tm_compute_mat_b[TM_COMPUTE_MAT_SIZE][TM_COMPUTE_MAT_SIZE];
+
+/* Define the output of the kernel being measured and of the scalar reference.  */
+
+static short tm_compute_q15_output[TM_COMPUTE_FIR_BLOCK];
+static short tm_compute_q15_reference[TM_COMPUTE_FIR_BLOCK];
+static float tm_compute_f32_output[2 * TM_COMPUTE_FFT_SIZE];
+static float tm_compute_f32_reference[2 * TM_COMPUTE_FFT_SIZE];
+
+/* Define a kernel version of the test.  */
+
+typedef struct tm_compute_kernel {
+    const char *name;
+    const char *variant;
+    void (*run)(void);
+    int (*check)(void);
+} tm_compute_kernel_t;
+
+/* Define the kernel version run by the test thread.  */
+
+static const tm_compute_kernel_t *volatile tm_compute_current;
+
+/* Define the test thread prototypes.  */
+
+void tm_compute_processing_thread_0_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_compute_processing_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_compute_processing_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_compute_processing_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_compute_processing_initialize);
+
+    return 0;
+}
+
+/* Saturate a q15 multiply-accumulate result, the accumulator wraps at 32 bits like SMLAD.  */
+static short tm_compute_q15_saturate(unsigned int accumulator)
+{
+    int value = (int)accumulator >> 15;
+
+    if (value > 32767) {
+        value = 32767;
+    } else if (value < -32768) {
+        value = -32768;
+    }
+
+    return (short)value;
+}
+
+/* Define the scalar q15 FIR filter.  */
+static void tm_compute_fir_q15_scalar(short *output)
+{
+    unsigned int accumulator;
+    int n;
+    int k;
+
+    for (n = 0; n < TM_COMPUTE_FIR_BLOCK; n++) {
+        accumulator = 0;
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k++) {
+            accumulator += (unsigned int)(tm_compute_fir_q15_input[n + k] * tm_compute_fir_q15_coeff[k]);
+        }
+        output[n] = tm_compute_q15_saturate(accumulator);
+    }
+}
+
+/* Define the scalar float FIR filter.  */
+static void tm_compute_fir_f32_scalar(float *output)
+{
+    float accumulator;
+    int n;
+    int k;
+
+    for (n = 0; n < TM_COMPUTE_FIR_BLOCK; n++) {
+        accumulator = 0.0f;
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k++) {
+            accumulator += tm_compute_fir_f32_input[n + k] * tm_compute_fir_f32_coeff[k];
+        }
+        output[n] = accumulator;
+    }
+}
+
+/*
+ * Define the float FFT, an iterative radix-2 decimation in time transform of
+ * the real input, with the result stored as interleaved real and imaginary parts.
+ */
+static void tm_compute_fft_f32_scalar(float *output)
+{
+    float wr, wi, tr, ti;
+    int size, half, step;
+    int i, j, k, r;
+
+    /* Load the input in bit reversed order.  */
+    for (i = 0; i < TM_COMPUTE_FFT_SIZE; i++) {
+        r = 0;
+        for (j = 0; j < TM_COMPUTE_FFT_LOG2; j++) {
+            r |= ((i >> j) & 1) << (TM_COMPUTE_FFT_LOG2 - 1 - j);
+        }
+        output[2 * r] = tm_compute_fft_input[i];
+        output[2 * r + 1] = 0.0f;
+    }
+
+    for (size = 2; size <= TM_COMPUTE_FFT_SIZE; size *= 2) {
+        half = size / 2;
+        step = TM_COMPUTE_FFT_SIZE / size;
+        for (i = 0; i < TM_COMPUTE_FFT_SIZE; i += size) {
+            for (k = 0; k < half; k++) {
+                wr = tm_compute_fft_cos[k * step];
+                wi = -tm_compute_fft_sin[k * step];
+                j = i + k;
+                tr = output[2 * (j + half)] * wr - output[2 * (j + half) + 1] * wi;
+                ti = output[2 * (j + half)] * wi + output[2 * (j + half) + 1] * wr;
+                output[2 * (j + half)] = output[2 * j] - tr;
+                output[2 * (j + half) + 1] = output[2 * j + 1] - ti;
+                output[2 * j] += tr;
+                output[2 * j + 1] += ti;
+            }
+        }
+    }
+}
+
+/* Define the direct DFT used as the reference of the FFT.  */
+static void tm_compute_dft_f32_reference(float *output)
+{
+    float re, im;
+    int n, k;
+
+    for (k = 0; k < TM_COMPUTE_FFT_SIZE; k++) {
+        re = 0.0f;
+        im = 0.0f;
+        for (n = 0; n < TM_COMPUTE_FFT_SIZE; n++) {
+            int index = (n * k) % TM_COMPUTE_FFT_SIZE;
+            float c = (index < TM_COMPUTE_FFT_SIZE / 2) ? tm_compute_fft_cos[index] : -tm_compute_fft_cos[index - TM_COMPUTE_FFT_SIZE / 2];
+            float s = (index < TM_COMPUTE_FFT_SIZE / 2) ? tm_compute_fft_sin[index] : -tm_compute_fft_sin[index - TM_COMPUTE_FFT_SIZE / 2];
+            re += tm_compute_fft_input[n] * c;
+            im -= tm_compute_fft_input[n] * s;
+        }
+        output[2 * k] = re;
+        output[2 * k + 1] = im;
+    }
+}
+
+/* Define the scalar float matrix multiply.  */
+static void tm_compute_mat_f32_scalar(float *output)
+{
+    float accumulator;
+    int i, j, k;
+
+    for (i = 0; i < TM_COMPUTE_MAT_SIZE; i++) {
+        for (j = 0; j < TM_COMPUTE_MAT_SIZE; j++) {
+            accumulator = 0.0f;
+            for (k = 0; k < TM_COMPUTE_MAT_SIZE; k++) {
+                accumulator += tm_compute_mat_a[i][k] * tm_compute_mat_b[k][j];
+            }
+            output[i * TM_COMPUTE_MAT_SIZE + j] = accumulator;
+        }
+    }
+}
+
+#ifdef TM_COMPUTE_SIMD
+/* Define the vectorized q15 FIR filter, with the same 32-bit wrapping accumulator.  */
+static void tm_compute_fir_q15_simd(short *output)
+{
+    int n;
+    int k;
+
+    for (n = 0; n < TM_COMPUTE_FIR_BLOCK; n++) {
+#if defined(TM_COMPUTE_SIMD_MVE)
+        int32_t accumulator = 0;
+
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k += 8) {
+            accumulator = vmladavaq_s16(accumulator, vld1q_s16(&tm_compute_fir_q15_input[n + k]),
+                                        vld1q_s16(&tm_compute_fir_q15_coeff[k]));
+        }
+        output[n] = tm_compute_q15_saturate((unsigned int)accumulator);
+#elif defined(TM_COMPUTE_SIMD_NEON)
+        int32x4_t accumulator = vdupq_n_s32(0);
+        int32x2_t sum;
+
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k += 4) {
+            accumulator = vmlal_s16(accumulator, vld1_s16(&tm_compute_fir_q15_input[n + k]),
+                                    vld1_s16(&tm_compute_fir_q15_coeff[k]));
+        }
+        sum = vadd_s32(vget_low_s32(accumulator), vget_high_s32(accumulator));
+        sum = vpadd_s32(sum, sum);
+        output[n] = tm_compute_q15_saturate((unsigned int)vget_lane_s32(sum, 0));
+#else
+        vint32m1_t accumulator = __riscv_vmv_s_x_i32m1(0, 1);
+        size_t vl;
+
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k += vl) {
+            vl = __riscv_vsetvl_e16m1(TM_COMPUTE_FIR_TAPS - k);
+            accumulator = __riscv_vredsum_vs_i32m2_i32m1(
+                __riscv_vwmul_vv_i32m2(__riscv_vle16_v_i16m1(&tm_compute_fir_q15_input[n + k], vl),
+                                       __riscv_vle16_v_i16m1(&tm_compute_fir_q15_coeff[k], vl), vl),
+                accumulator, vl);
+        }
+        output[n] = tm_compute_q15_saturate((unsigned int)__riscv_vmv_x_s_i32m1_i32(accumulator));
+#endif
+    }
+}
+
+/* Define the vectorized float FIR filter.  */
+static void tm_compute_fir_f32_simd(float *output)
+{
+    int n;
+    int k;
+
+    for (n = 0; n < TM_COMPUTE_FIR_BLOCK; n++) {
+#if defined(TM_COMPUTE_SIMD_MVE) || defined(TM_COMPUTE_SIMD_NEON)
+        float32x4_t accumulator = vdupq_n_f32(0.0f);
+
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k += 4) {
+            accumulator = tm_compute_mla_f32(accumulator, vld1q_f32(&tm_compute_fir_f32_input[n + k]),
+                                             vld1q_f32(&tm_compute_fir_f32_coeff[k]));
+        }
+        output[n] = vgetq_lane_f32(accumulator, 0) + vgetq_lane_f32(accumulator, 1) +
+                    vgetq_lane_f32(accumulator, 2) + vgetq_lane_f32(accumulator, 3);
+#else
+        vfloat32m1_t accumulator = __riscv_vfmv_s_f_f32m1(0.0f, 1);
+        size_t vl;
+
+        for (k = 0; k < TM_COMPUTE_FIR_TAPS; k += vl) {
+            vl = __riscv_vsetvl_e32m1(TM_COMPUTE_FIR_TAPS - k);
+            accumulator = __riscv_vfredusum_vs_f32m1_f32m1(
+                __riscv_vfmul_vv_f32m1(__riscv_vle32_v_f32m1(&tm_compute_fir_f32_input[n + k], vl),
+                                       __riscv_vle32_v_f32m1(&tm_compute_fir_f32_coeff[k], vl), vl),
+                accumulator, vl);
+        }
+        output[n] = __riscv_vfmv_f_s_f32m1_f32(accumulator);
+#endif
+    }
+}
+
+/* Define the vectorized float matrix multiply, accumulating whole rows of the result.  */
+static void tm_compute_mat_f32_simd(float *output)
+{
+    int i, j, k;
+
+    for (i = 0; i < TM_COMPUTE_MAT_SIZE; i++) {
+#if defined(TM_COMPUTE_SIMD_MVE) || defined(TM_COMPUTE_SIMD_NEON)
+        for (j = 0; j < TM_COMPUTE_MAT_SIZE; j += 4) {
+            float32x4_t accumulator = vdupq_n_f32(0.0f);
+
+            for (k = 0; k < TM_COMPUTE_MAT_SIZE; k++) {
+                accumulator = tm_compute_mla_f32(accumulator, vld1q_f32(&tm_compute_mat_b[k][j]),
+                                                 vdupq_n_f32(tm_compute_mat_a[i][k]));
+            }
+            vst1q_f32(&output[i * TM_COMPUTE_MAT_SIZE + j], accumulator);
+        }
+#else
+        size_t vl;
+
+        for (j = 0; j < TM_COMPUTE_MAT_SIZE; j += vl) {
+            vfloat32m1_t accumulator;
+
+            vl = __riscv_vsetvl_e32m1(TM_COMPUTE_MAT_SIZE - j);
+            accumulator = __riscv_vfmv_v_f_f32m1(0.0f, vl);
+            for (k = 0; k < TM_COMPUTE_MAT_SIZE; k++) {
+                accumulator = __riscv_vfmacc_vf_f32m1(accumulator, tm_compute_mat_a[i][k],
+                                                      __riscv_vle32_v_f32m1(&tm_compute_mat_b[k][j], vl), vl);
+            }
+            __riscv_vse32_v_f32m1(&output[i * TM_COMPUTE_MAT_SIZE + j], accumulator, vl);
+        }
+#endif
+    }
+}
+#endif
+
+/* Compare float results, allowing for the rounding of a different summation order.  */
+static int tm_compute_check_f32(int count)
+{
+    float magnitude = 0.0f;
+    float difference;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (tm_compute_f32_reference[i] > magnitude) {
+            magnitude = tm_compute_f32_reference[i];
+        } else if (-tm_compute_f32_reference[i] > magnitude) {
+            magnitude = -tm_compute_f32_reference[i];
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        difference = tm_compute_f32_output[i] - tm_compute_f32_reference[i];
+        if ((difference > magnitude * 1e-4f) || (-difference > magnitude * 1e-4f)) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+/* Define the run and check functions of each kernel version.  */
+
+static void tm_compute_fir_q15_scalar_run(void)
+{
+    tm_compute_fir_q15_scalar(tm_compute_q15_output);
+}
+
+static int tm_compute_fir_q15_check(void)
+{
+    int i;
+
+    tm_compute_fir_q15_scalar(tm_compute_q15_reference);
+    for (i = 0; i < TM_COMPUTE_FIR_BLOCK; i++) {
+        if (tm_compute_q15_output[i] != tm_compute_q15_reference[i]) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+static void tm_compute_fir_f32_scalar_run(void)
+{
+    tm_compute_fir_f32_scalar(tm_compute_f32_output);
+}
+
+static int tm_compute_fir_f32_check(void)
+{
+    tm_compute_fir_f32_scalar(tm_compute_f32_reference);
+    return tm_compute_check_f32(TM_COMPUTE_FIR_BLOCK);
+}
+
+static void tm_compute_fft_f32_scalar_run(void)
+{
+    tm_compute_fft_f32_scalar(tm_compute_f32_output);
+}
+
+static int tm_compute_fft_f32_check(void)
+{
+    tm_compute_dft_f32_reference(tm_compute_f32_reference);
+    return tm_compute_check_f32(2 * TM_COMPUTE_FFT_SIZE);
+}
+
+static void tm_compute_mat_f32_scalar_run(void)
+{
+    tm_compute_mat_f32_scalar(tm_compute_f32_output);
+}
+
+static int tm_compute_mat_f32_check(void)
+{
+    tm_compute_mat_f32_scalar(tm_compute_f32_reference);
+    return tm_compute_check_f32(TM_COMPUTE_MAT_SIZE * TM_COMPUTE_MAT_SIZE);
+}
+
+#ifdef TM_COMPUTE_SIMD
+static void tm_compute_fir_q15_simd_run(void)
+{
+    tm_compute_fir_q15_simd(tm_compute_q15_output);
+}
+
+static void tm_compute_fir_f32_simd_run(void)
+{
+    tm_compute_fir_f32_simd(tm_compute_f32_output);
+}
+
+static void tm_compute_mat_f32_simd_run(void)
+{
+    tm_compute_mat_f32_simd(tm_compute_f32_output);
+}
+#endif
+
+/* Define the kernel versions, in the order they are measured.  */
+
+static const tm_compute_kernel_t tm_compute_kernel[] = {
+    {"fir q15",    "scalar",        tm_compute_fir_q15_scalar_run, tm_compute_fir_q15_check},
+#ifdef TM_COMPUTE_SIMD
+    {"fir q15",    TM_COMPUTE_SIMD, tm_compute_fir_q15_simd_run,   tm_compute_fir_q15_check},
+#endif
+    {"fir f32",    "scalar",        tm_compute_fir_f32_scalar_run, tm_compute_fir_f32_check},
+#ifdef TM_COMPUTE_SIMD
+    {"fir f32",    TM_COMPUTE_SIMD, tm_compute_fir_f32_simd_run,   tm_compute_fir_f32_check},
+#endif
+    {"fft f32",    "scalar",        tm_compute_fft_f32_scalar_run, tm_compute_fft_f32_check},
+    {"matrix f32", "scalar",        tm_compute_mat_f32_scalar_run, tm_compute_mat_f32_check},
+#ifdef TM_COMPUTE_SIMD
+    {"matrix f32", TM_COMPUTE_SIMD, tm_compute_mat_f32_simd_run,   tm_compute_mat_f32_check},
+#endif
+};
+
+#define TM_COMPUTE_KERNEL_NUM (sizeof(tm_compute_kernel) / sizeof(tm_compute_kernel[0]))
+
+/* Define the results of each kernel version.  */
+
+static unsigned long tm_compute_ops[TM_COMPUTE_KERNEL_NUM];
+static int tm_compute_status[TM_COMPUTE_KERNEL_NUM];
+
+/* Fill the inputs of the kernels with fixed pseudo-random data.  */
+static void tm_compute_processing_fill(void)
+{
+    unsigned int state = 0x12345678;
+    double c = 1.0, s = 0.0, t;
+    int i, j;
+
+    /* The coefficients of the q15 filter sum to less than one, so the accumulator cannot overflow.  */
+    for (i = 0; i < TM_COMPUTE_FIR_BLOCK + TM_COMPUTE_FIR_TAPS; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        tm_compute_fir_q15_input[i] = (short)state;
+        tm_compute_fir_f32_input[i] = (float)(short)state / 32768.0f;
+    }
+    for (i = 0; i < TM_COMPUTE_FIR_TAPS; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        tm_compute_fir_q15_coeff[i] = (short)((short)state / TM_COMPUTE_FIR_TAPS);
+        tm_compute_fir_f32_coeff[i] = (float)tm_compute_fir_q15_coeff[i] / 32768.0f;
+    }
+    for (i = 0; i < TM_COMPUTE_FFT_SIZE; i++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        tm_compute_fft_input[i] = (float)(short)state / 32768.0f;
+    }
+    for (i = 0; i < TM_COMPUTE_MAT_SIZE; i++) {
+        for (j = 0; j < TM_COMPUTE_MAT_SIZE; j++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            tm_compute_mat_a[i][j] = (float)(short)state / 32768.0f;
+            tm_compute_mat_b[j][i] = (float)(short)(state >> 16) / 32768.0f;
+        }
+    }
+
+    /* Rotate by 2*pi/N to build the twiddle factors, without the math library.  */
+    for (i = 0; i < TM_COMPUTE_FFT_SIZE / 2; i++) {
+        tm_compute_fft_cos[i] = (float)c;
+        tm_compute_fft_sin[i] = (float)s;
+        t = c * 0.99969881869620422 - s * 0.024541228522912288;
+        s = s * 0.99969881869620422 + c * 0.024541228522912288;
+        c = t;
+    }
+}
+
+/* Define the compute processing test initialization.  */
+
+void tm_compute_processing_initialize(void)
+{
+    unsigned int i;
+
+    tm_compute_processing_fill();
+
+    for (i = 0; i < TM_COMPUTE_KERNEL_NUM; i++) {
+
+        /* Run the test thread on the kernel version for one period.  */
+        tm_compute_current = &tm_compute_kernel[i];
+
+        /* Create thread 0 at priority 10.  */
+        tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_compute_processing_thread_0_entry);
+
+        /* Resume thread 0.  */
+        tm_thread_resume(0);
+
+        tm_compute_processing_thread_report();
+    }
+}
+
+/* Define the compute processing thread.  */
+void tm_compute_processing_thread_0_entry(void *p1, void *p2, void *p3)
+{
+    const tm_compute_kernel_t *kernel = tm_compute_current;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Run one pass of the kernel.  */
+        kernel->run();
+
+        /* Increment the compute processing counter.  */
+        tm_counter_increment(&tm_compute_processing_counter);
+    }
+}
+
+/* Define the compute processing counter read function.  */
+static unsigned long long tm_compute_processing_counter_read(void)
+{
+    return tm_counter_read(&tm_compute_processing_counter);
+}
+
+/*
+ * Define the compute processing reporting function. It measures the current
+ * kernel version and prints the test once the last one has been measured.
+ */
+void tm_compute_processing_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long long rate;
+    unsigned int index;
+    unsigned int i;
+    char buffer[16];
+    int failed;
+
+    index = (unsigned int)(tm_compute_current - tm_compute_kernel);
+
+    /* Measure the kernel version for one period, then stop it and check its output.  */
+    tm_compute_ops[index] = tm_measure(TM_COMPUTE_PROCESSING_ID, tm_compute_processing_counter_read);
+    tm_thread_detach();
+    tm_compute_status[index] = (tm_compute_ops[index] != 0) ? tm_compute_current->check() : TM_ERROR;
+
+    if (index + 1 < TM_COMPUTE_KERNEL_NUM) {
+        return;
+    }
+
+    /* Total the passes of all kernel versions.  */
+    period_counter = 0;
+    failed = 0;
+    for (i = 0; i < TM_COMPUTE_KERNEL_NUM; i++) {
+        period_counter += tm_compute_ops[i];
+        failed |= (tm_compute_status[i] != TM_SUCCESS);
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Compute processing thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_COMPUTE_PROCESSING_ID, "kernel differs from scalar reference");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Compute Processing Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)TM_COMPUTE_KERNEL_NUM, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  kernel", "variant", "passes", "MMAC/s");
+    for (i = 0; i < TM_COMPUTE_KERNEL_NUM; i++) {
+
+        /* Compute the MMAC/s, x100.  */
+        rate = (unsigned long long)tm_compute_ops[i] * TM_COMPUTE_MACS / (TM_TEST_DURATION_VALUE * 10000ULL);
+
+        printf("|   %-38s | %-10s | %-10lu | %-10s |\n", tm_compute_kernel[i].name, tm_compute_kernel[i].variant,
+               tm_compute_ops[i], (tm_compute_status[i] == TM_SUCCESS) ? tm_measure_format(buffer, sizeof(buffer), rate) : "FAILED");
+    }
+    tm_measure_report(TM_COMPUTE_PROCESSING_ID);
+
+    tm_teardown();
+}
@@ -12,6 +12,373 @@
 #include "rtthread.h"
 
 #define CONFIG_MAIN_THREAD_PRIORITY RT_MAIN_THREAD_PRIORITY
-#define CONFIG_TESTCASE_NUM 8
+#define CONFIG_TESTCASE_NUM 20
+
+/*
+ * The suite runs from its own controller thread. The shell command only
+ * starts it; "thread_metric status" and "thread_metric result" can be used
+ * while it runs. TM_CONTROLLER_CPU binds the controller to a core on SMP
+ * builds, -1 leaves it unbound.
+ */
+#ifndef TM_CONTROLLER_PRIORITY
+#define TM_CONTROLLER_PRIORITY CONFIG_MAIN_THREAD_PRIORITY
+#endif
+
+#ifndef TM_CONTROLLER_STACK_SIZE
+#define TM_CONTROLLER_STACK_SIZE 4096
+#endif
+
+#ifndef TM_CONTROLLER_CPU
+#define TM_CONTROLLER_CPU -1
+#endif
+
+/*
+ * Provide the services on the measured path (thread resume/suspend/relinquish,
+ * queue, semaphore and memory pool operations) as static inline functions
+ * instead of out-of-line calls into tm_porting_layer_rtthread.c. Building the
+ * suite both ways separates the RTOS cost from the porting layer cost.
+ */
+#ifndef TM_PORTING_LAYER_INLINE
+#define TM_PORTING_LAYER_INLINE 0
+#endif
+
+/*
+ * Default warm-up period of each test in milliseconds. The operations counted
+ * during the warm-up are reported as cold throughput and are not part of the
+ * measured period. tm_measure_warmup() overrides it per test; 0 disables it.
+ */
+#ifndef TM_TEST_WARMUP_MS
+#define TM_TEST_WARMUP_MS 0
+#endif
+
+/*
+ * Sample the counters of each test every TM_TIME_SERIES_PERIOD_MS from a
+ * sampler thread at TM_TIME_SERIES_PRIORITY, which must be higher than the
+ * priority of all test threads. Up to TM_TIME_SERIES_MAX_SAMPLES samples are
+ * kept per test and reported as a throughput time series.
+ */
+#ifndef TM_TIME_SERIES_ENABLE
+#define TM_TIME_SERIES_ENABLE 0
+#endif
+
+#ifndef TM_TIME_SERIES_PERIOD_MS
+#define TM_TIME_SERIES_PERIOD_MS 100
+#endif
+
+#ifndef TM_TIME_SERIES_PRIORITY
+#define TM_TIME_SERIES_PRIORITY 1
+#endif
+
+#ifndef TM_TIME_SERIES_MAX_SAMPLES
+#define TM_TIME_SERIES_MAX_SAMPLES 64
+#endif
+
+/*
+ * Replace the fixed measurement period by windows of TM_ADAPTIVE_WINDOW_MS.
+ * Windows are added until the 95% confidence interval of the operations per
+ * window, relative to its mean, is within TM_ADAPTIVE_TARGET (in units of
+ * 0.01%, i.e. 50 is 0.5%), or until TM_ADAPTIVE_TIME_CAP_MS or
+ * TM_ADAPTIVE_MAX_WINDOWS is reached. The period total is then scaled to
+ * the TM_TEST_DURATION period.
+ */
+#ifndef TM_ADAPTIVE_ENABLE
+#define TM_ADAPTIVE_ENABLE 0
+#endif
+
+#ifndef TM_ADAPTIVE_WINDOW_MS
+#define TM_ADAPTIVE_WINDOW_MS 200
+#endif
+
+#ifndef TM_ADAPTIVE_MIN_WINDOWS
+#define TM_ADAPTIVE_MIN_WINDOWS 5
+#endif
+
+#ifndef TM_ADAPTIVE_MAX_WINDOWS
+#define TM_ADAPTIVE_MAX_WINDOWS 100
+#endif
+
+#ifndef TM_ADAPTIVE_TARGET
+#define TM_ADAPTIVE_TARGET 50
+#endif
+
+#ifndef TM_ADAPTIVE_TIME_CAP_MS
+#define TM_ADAPTIVE_TIME_CAP_MS 20000
+#endif
+
+/*
+ * Run a calibration phase before the tests. It times the loop skeleton of
+ * each test with the RTOS services stubbed out, so the report can show the
+ * net timestamp counts per RTOS operation with the harness overhead
+ * subtracted.
+ */
+#ifndef TM_CALIBRATION_ENABLE
+#define TM_CALIBRATION_ENABLE 0
+#endif
+
+/* Number of operations per calibration round, the fastest of the rounds is kept */
+#ifndef TM_CALIBRATION_ITERATIONS
+#define TM_CALIBRATION_ITERATIONS 10000
+#endif
+
+#ifndef TM_CALIBRATION_ROUNDS
+#define TM_CALIBRATION_ROUNDS 5
+#endif
+
+/*
+ * Watch every test while it is measured. If its counter makes no progress
+ * for TM_WATCHDOG_TIMEOUT_MS, e.g. because the interrupt trigger is not
+ * wired or a test thread deadlocked, the measurement ends early, the test
+ * threads are deleted, the test is reported as FAILED and the suite
+ * continues with the next test; the same happens when a test thread reports
+ * a failure with tm_measure_fail(). The watchdog runs in the sampler thread, at
+ * TM_WATCHDOG_PRIORITY unless the time series is enabled, which must be
+ * higher than the priority of all test threads. The sampler wakes up four
+ * times per timeout and perturbs the results, so it is off by default.
+ */
+#ifndef TM_WATCHDOG_ENABLE
+#define TM_WATCHDOG_ENABLE 0
+#endif
+
+#ifndef TM_WATCHDOG_TIMEOUT_MS
+#define TM_WATCHDOG_TIMEOUT_MS 1000
+#endif
+
+#ifndef TM_WATCHDOG_PRIORITY
+#define TM_WATCHDOG_PRIORITY 1
+#endif
+
+/*
+ * Validate every message of the message processing test instead of only its
+ * last word. Each message carries a sequence number, a payload derived from
+ * it and a checksum over both; a lost, reordered or corrupted message fails
+ * the test. The extra work per message is included in the measured loop.
+ */
+#ifndef TM_MESSAGE_VALIDATE
+#define TM_MESSAGE_VALIDATE 0
+#endif
+
+/*
+ * Select the kernel of the basic processing test: 0 integer add/xor mix,
+ * 1 CRC32, 2 memcpy of half of the array, 3 branchy state machine. The
+ * kernel runs on non-volatile data and each pass returns a checksum that is
+ * published by the test thread and verified by the reporter.
+ */
+#ifndef TM_BASIC_KERNEL
+#define TM_BASIC_KERNEL 0
+#endif
+
+/*
+ * Sweep the working set of the basic processing test before its standard
+ * run. The array size doubles from TM_BASIC_SWEEP_MIN_BYTES up to
+ * TM_BASIC_SWEEP_MAX_BYTES, each size is measured for one test period and
+ * its throughput is reported, showing the cache and memory bus cliffs.
+ * TM_BASIC_SWEEP_PLACEMENT places the working set in the heap (0, the sweep
+ * stops at the first size that cannot be allocated), in a static array (1),
+ * or in a static array in the TM_BASIC_SWEEP_SECTION linker section (2),
+ * e.g. a TCM. The static array is TM_BASIC_SWEEP_MAX_BYTES large.
+ */
+#ifndef TM_BASIC_SWEEP_ENABLE
+#define TM_BASIC_SWEEP_ENABLE 0
+#endif
+
+#ifndef TM_BASIC_SWEEP_MIN_BYTES
+#define TM_BASIC_SWEEP_MIN_BYTES 1024
+#endif
+
+#ifndef TM_BASIC_SWEEP_MAX_BYTES
+#define TM_BASIC_SWEEP_MAX_BYTES (4 * 1024 * 1024)
+#endif
+
+#ifndef TM_BASIC_SWEEP_PLACEMENT
+#define TM_BASIC_SWEEP_PLACEMENT 0
+#endif
+
+#ifndef TM_BASIC_SWEEP_SECTION
+#define TM_BASIC_SWEEP_SECTION ".tcm"
+#endif
+
+/*
+ * Run the compute processing test after the standard tests. It measures
+ * q15 and float FIR, float FFT and float matrix kernels, in scalar and, when
+ * the compiler targets Helium, NEON or RVV, vectorized versions, and reports
+ * MMAC/s. Each version runs for one test period.
+ */
+#ifndef TM_COMPUTE_ENABLE
+#define TM_COMPUTE_ENABLE 0
+#endif
+
+/*
+ * Run the parallel processing test on SMP builds. It runs the basic
+ * processing kernel in one thread per core, first on one core, then on all
+ * cores with a private array each and then with one shared array, and
+ * reports the per-core and aggregate throughput and the speedup over one
+ * core. Select the memcpy kernel with TM_BASIC_KERNEL to have the cores
+ * write to the shared array.
+ */
+#ifndef TM_PARALLEL_ENABLE
+#define TM_PARALLEL_ENABLE 0
+#endif
+
+/*
+ * Run the memory bandwidth test. It measures the STREAM copy, scale, add and
+ * triad kernels over three arrays of TM_BANDWIDTH_ARRAY_BYTES, a multiple of
+ * 64, and compares libc memcpy/memset with rt_memcpy/rt_memset and a hand
+ * vectorized copy, in MB/s. Make the arrays larger than the caches to
+ * measure the memory. With TM_BANDWIDTH_PREEMPT_MS set, a higher priority
+ * thread preempts the test every TM_BANDWIDTH_PREEMPT_MS milliseconds.
+ */
+#ifndef TM_BANDWIDTH_ENABLE
+#define TM_BANDWIDTH_ENABLE 0
+#endif
+
+#ifndef TM_BANDWIDTH_ARRAY_BYTES
+#define TM_BANDWIDTH_ARRAY_BYTES 32768
+#endif
+
+#ifndef TM_BANDWIDTH_PREEMPT_MS
+#define TM_BANDWIDTH_PREEMPT_MS 0
+#endif
+
+/*
+ * Run the FPU scheduling test after the cooperative and preemptive tests.
+ * It repeats both with every thread keeping live floating-point state across
+ * its yield or suspend, and reports the switch cost next to that of the
+ * integer-only tests. Only meaningful on cores with an FPU.
+ */
+#ifndef TM_FPU_ENABLE
+#define TM_FPU_ENABLE 0
+#endif
+
+/*
+ * Run the queue comparison test. It passes 4, 16 and 64 byte messages from
+ * a producer to a consumer thread through a lock-free SPSC ring built on C11
+ * atomics, an rt_messagequeue and an rt_ringbuffer (with
+ * RT_USING_DEVICE_IPC), each TM_QUEUE_COMPARISON_DEPTH messages deep, on
+ * one core and across two. rt_ringbuffer has no memory barriers and may
+ * fail the cross-core check on weakly ordered cores. Needs <stdatomic.h>.
+ */
+#ifndef TM_QUEUE_COMPARISON_ENABLE
+#define TM_QUEUE_COMPARISON_ENABLE 0
+#endif
+
+#ifndef TM_QUEUE_COMPARISON_DEPTH
+#define TM_QUEUE_COMPARISON_DEPTH 16
+#endif
+
+/*
+ * Run the pool comparison test. It runs the allocate/free loop of the memory
+ * allocation test in 1 to N threads, one per core, against an rt_mempool, a
+ * lock-free pool and a pool with a per-core cache of blocks, and reports
+ * the throughput of each relative to rt_mempool. Needs <stdatomic.h>.
+ */
+#ifndef TM_POOL_COMPARISON_ENABLE
+#define TM_POOL_COMPARISON_ENABLE 0
+#endif
+
+/*
+ * Run the semaphore comparison test. It runs the get/put loop of the
+ * synchronization processing test on an rt_semaphore and on a semaphore
+ * whose uncontended path only uses atomics, uncontended, with two threads
+ * handing it off on one core and with one thread per core contending for
+ * it. Needs <stdatomic.h>.
+ */
+#ifndef TM_SEMAPHORE_COMPARISON_ENABLE
+#define TM_SEMAPHORE_COMPARISON_ENABLE 0
+#endif
+
+/*
+ * Run the atomic operations test. It measures the rt_atomic load, store,
+ * add, exchange and compare-exchange operations and full, acquire and
+ * release fences in timestamp counts per operation, in one thread and, on
+ * SMP builds, in one thread per core on a shared and on private cache
+ * lines. Needs the rt_atomic API of RT-Thread 5.
+ */
+#ifndef TM_ATOMIC_ENABLE
+#define TM_ATOMIC_ENABLE 0
+#endif
+
+/*
+ * Run the spinlock test. It measures rt_spin_lock, rt_spin_lock_irqsave,
+ * rt_enter_critical and rt_hw_interrupt_disable around a short critical
+ * section in one thread and, on SMP builds, 2 to N cores contending for one
+ * rt_spin_lock, with the handoff latency between cores and the fairness of
+ * the acquisitions. The handoff latency needs a timestamp counter common to
+ * all cores.
+ */
+#ifndef TM_SPINLOCK_ENABLE
+#define TM_SPINLOCK_ENABLE 0
+#endif
+
+/*
+ * Run the IPI latency test on SMP builds. A thread on core 0 wakes core 1,
+ * idle or busy, by releasing a semaphore a thread on core 1 waits on and by
+ * sending it TM_IPI_VECTOR, and the latency distribution of each is
+ * reported. TM_IPI_VECTOR must be an IPI the kernel does not use; the
+ * handler of the test is installed on it. The timestamp counter must be
+ * common to all cores, as on QEMU virt.
+ */
+#ifndef TM_IPI_ENABLE
+#define TM_IPI_ENABLE 0
+#endif
+
+#ifndef TM_IPI_VECTOR
+#define TM_IPI_VECTOR RT_MAX_IPI
+#endif
+
+/*
+ * Run the thread migration test on SMP builds. Two worker threads per core
+ * pass one token per core around a ring, bound to the cores, without
+ * affinity and rebound to the next core on every pass, and the report shows
+ * the throughput, the number of migrations and the extra cost of each
+ * migration over the bound workers.
+ */
+#ifndef TM_MIGRATION_ENABLE
+#define TM_MIGRATION_ENABLE 0
+#endif
+
+/*
+ * Pad every test counter to a cache line. With 0 the counters of all tests
+ * are packed next to each other, as plain adjacent globals, so that comparing
+ * the results of both layouts shows how much of an SMP result is coherence
+ * traffic between the counters rather than the work measured.
+ */
+#ifndef TM_COUNTER_PADDED
+#define TM_COUNTER_PADDED 1
+#endif
+
+/*
+ * Run the false sharing test. One thread per core increments its own
+ * counter, with the counters of all threads packed into one cache line and
+ * padded to one cache line each, and the report shows the throughput of the
+ * padded counters relative to the packed ones.
+ */
+#ifndef TM_FALSE_SHARING_ENABLE
+#define TM_FALSE_SHARING_ENABLE 0
+#endif
+
+/*
+ * Allow "thread_metric concurrent test[:core[:priority]] ..." to run up to
+ * TM_CONCURRENT_MAX_TESTS of the eight Thread-Metric tests at once, e.g.
+ * "5:0 3:1 7:1" for message processing on core 0 with interrupt processing
+ * and memory allocation on core 1, or "1 5:-1:2" for all on any core, the
+ * second test two priority levels lower. Each test runs alone first, with
+ * the same placement, and the throughput of each at once is reported next
+ * to its isolated baseline. Every test has its own porting layer objects,
+ * at the cost of TM_CONCURRENT_MAX_TESTS times their memory. The watchdog
+ * and the time series are off while the tests run at once; the tests must
+ * measure a fixed period, so TM_ADAPTIVE_ENABLE must be 0 (checked below).
+ */
+#ifndef TM_CONCURRENT_ENABLE
+#define TM_CONCURRENT_ENABLE 0
+#endif
+
+#ifndef TM_CONCURRENT_MAX_TESTS
+#define TM_CONCURRENT_MAX_TESTS 4
+#endif
+
+/* The adaptive windows of all tests share one buffer and stop at different times.  */
+#if TM_CONCURRENT_ENABLE && TM_ADAPTIVE_ENABLE
+#error "TM_CONCURRENT_ENABLE needs TM_ADAPTIVE_ENABLE 0, the tests must measure a fixed period"
+#endif
 
 #endif /* APPLICATIONS_RT_THREAD_METRIC_SRC_TM_CONFIG_H_ */
@@ -43,11 +43,11 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_cooperative_thread_0_counter;
-unsigned long tm_cooperative_thread_1_counter;
-unsigned long tm_cooperative_thread_2_counter;
-unsigned long tm_cooperative_thread_3_counter;
-unsigned long tm_cooperative_thread_4_counter;
+TM_COUNTER tm_cooperative_thread_0_counter;
+TM_COUNTER tm_cooperative_thread_1_counter;
+TM_COUNTER tm_cooperative_thread_2_counter;
+TM_COUNTER tm_cooperative_thread_3_counter;
+TM_COUNTER tm_cooperative_thread_4_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -81,6 +81,13 @@ void tm_cooperative_scheduling_initialize(void)
 {
     int prio = CONFIG_MAIN_THREAD_PRIORITY + 1;
 
+    /* Clear the counters of a previous run, the report checks them against each other.  */
+    tm_counter_reset(&tm_cooperative_thread_0_counter);
+    tm_counter_reset(&tm_cooperative_thread_1_counter);
+    tm_counter_reset(&tm_cooperative_thread_2_counter);
+    tm_counter_reset(&tm_cooperative_thread_3_counter);
+    tm_counter_reset(&tm_cooperative_thread_4_counter);
+
     /* Create all 5 threads at the same priority as the main thread.  */
     tm_thread_create(0, prio, tm_cooperative_thread_0_entry);
     tm_thread_create(1, prio, tm_cooperative_thread_1_entry);
@@ -111,7 +118,7 @@ void tm_cooperative_thread_0_entry(void *p1, void *p2, void *p3)
         tm_thread_relinquish();
 
         /* Increment this thread's counter.  */
-        tm_cooperative_thread_0_counter++;
+        tm_counter_increment(&tm_cooperative_thread_0_counter);
     }
 }
 
@@ -128,7 +135,7 @@ void tm_cooperative_thread_1_entry(void *p1, void *p2, void *p3)
         tm_thread_relinquish();
 
         /* Increment this thread's counter.  */
-        tm_cooperative_thread_1_counter++;
+        tm_counter_increment(&tm_cooperative_thread_1_counter);
     }
 }
 
@@ -145,7 +152,7 @@ void tm_cooperative_thread_2_entry(void *p1, void *p2, void *p3)
         tm_thread_relinquish();
 
         /* Increment this thread's counter.  */
-        tm_cooperative_thread_2_counter++;
+        tm_counter_increment(&tm_cooperative_thread_2_counter);
     }
 }
 
@@ -162,7 +169,7 @@ void tm_cooperative_thread_3_entry(void *p1, void *p2, void *p3)
         tm_thread_relinquish();
 
         /* Increment this thread's counter.  */
-        tm_cooperative_thread_3_counter++;
+        tm_counter_increment(&tm_cooperative_thread_3_counter);
     }
 }
 
@@ -179,52 +186,80 @@ void tm_cooperative_thread_4_entry(void *p1, void *p2, void *p3)
         tm_thread_relinquish();
 
         /* Increment this thread's counter.  */
-        tm_cooperative_thread_4_counter++;
+        tm_counter_increment(&tm_cooperative_thread_4_counter);
+    }
+}
+
+/* Define the loop skeleton of the cooperative threads, with the RTOS services stubbed out.  */
+static TM_COUNTER tm_cooperative_skeleton_counter;
+
+static void tm_cooperative_skeleton(unsigned long iterations)
+{
+    while (iterations--) {
+
+        /* Relinquish to all other threads at same priority.  */
+        tm_calibration_stub(0, 0);
+
+        /* Increment this thread's counter.  */
+        tm_counter_increment(&tm_cooperative_skeleton_counter);
     }
 }
 
+/* Define the cooperative test calibration function.  */
+void tm_cooperative_scheduling_calibrate(void)
+{
+    tm_calibrate(TM_COOPERATIVE_SCHEDULING_ID, tm_cooperative_skeleton);
+}
+
+/* Define the cooperative test counter read function.  */
+static unsigned long long tm_cooperative_counter_total(void)
+{
+    /* Calculate the total of all the counters.  */
+    return tm_counter_read(&tm_cooperative_thread_0_counter) + tm_counter_read(&tm_cooperative_thread_1_counter) +
+        tm_counter_read(&tm_cooperative_thread_2_counter) + tm_counter_read(&tm_cooperative_thread_3_counter) +
+        tm_counter_read(&tm_cooperative_thread_4_counter);
+}
+
 /* Define the cooperative test reporting function.  */
 void tm_cooperative_thread_report(void)
 {
 
-    unsigned long total;
+    unsigned long long counter[5];
+    unsigned long long total;
+    unsigned long long average;
+    unsigned long period_total;
     unsigned long relative_time;
-    unsigned long last_total;
-    unsigned long average;
-
-    /* Initialize the last total.  */
-    last_total = 0;
+    int i;
 
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_total = tm_measure(TM_COOPERATIVE_SCHEDULING_ID, tm_cooperative_counter_total);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
-        /* Calculate the total of all the counters.  */
-        total = tm_cooperative_thread_0_counter + tm_cooperative_thread_1_counter +
-            tm_cooperative_thread_2_counter + tm_cooperative_thread_3_counter +
-            tm_cooperative_thread_4_counter;
+        /* Read all the counters and calculate their total.  */
+        counter[0] = tm_counter_read(&tm_cooperative_thread_0_counter);
+        counter[1] = tm_counter_read(&tm_cooperative_thread_1_counter);
+        counter[2] = tm_counter_read(&tm_cooperative_thread_2_counter);
+        counter[3] = tm_counter_read(&tm_cooperative_thread_3_counter);
+        counter[4] = tm_counter_read(&tm_cooperative_thread_4_counter);
+        total = counter[0] + counter[1] + counter[2] + counter[3] + counter[4];
 
         /* Calculate the average of all the counters.  */
         average = total / 5;
 
         /* See if there are any errors.  */
-        if ((tm_cooperative_thread_0_counter < (average - 1)) ||
-            (tm_cooperative_thread_0_counter > (average + 1)) ||
-            (tm_cooperative_thread_1_counter < (average - 1)) ||
-            (tm_cooperative_thread_1_counter > (average + 1)) ||
-            (tm_cooperative_thread_2_counter < (average - 1)) ||
-            (tm_cooperative_thread_2_counter > (average + 1)) ||
-            (tm_cooperative_thread_3_counter < (average - 1)) ||
-            (tm_cooperative_thread_3_counter > (average + 1)) ||
-            (tm_cooperative_thread_4_counter < (average - 1)) ||
-            (tm_cooperative_thread_4_counter > (average + 1))) {
+        for (i = 0; i < 5; i++) {
+            if ((counter[i] < (average - 1)) || (counter[i] > (average + 1))) {
+                break;
+            }
+        }
+        if (i < 5) {
 
             printf("ERROR: Invalid counter value(s). Cooperative counters should not "
                    "be more that 1 different than the average!\n");
@@ -233,12 +268,10 @@ void tm_cooperative_thread_report(void)
         /* Show the time period total.  */
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n", "Cooperative Scheduling Test",
-               total - last_total, relative_time, rt_tick_get());
-
-        /* Save the last total.  */
-        last_total = total;
+               period_total, relative_time, rt_tick_get());
+        tm_measure_report(TM_COOPERATIVE_SCHEDULING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
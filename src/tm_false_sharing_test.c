@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * False sharing test. One thread per core increments its own counter in
+ * batches of TM_FALSE_SHARING_BATCH, first with the counters of all threads
+ * packed into one cache line, then with each counter padded to a cache line
+ * of its own. Each layout runs for one test period. The report shows the
+ * increments of each layout, per core and relative to the packed layout,
+ * and whether the test counters of the suite are padded (TM_COUNTER_PADDED).
+ * With one core both layouts run the same.
+ */
+
+#include "tm_api.h"
+
+#define TM_FALSE_SHARING_BATCH 64
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_FALSE_SHARING_MAX_THREADS 8
+
+/* Define the layouts of the counters.  */
+#define TM_FALSE_SHARING_PACKED  0
+#define TM_FALSE_SHARING_PADDED  1
+#define TM_FALSE_SHARING_LAYOUTS 2
+
+static const char *tm_false_sharing_layout_name[TM_FALSE_SHARING_LAYOUTS] = {
+    "packed in one line",
+    "padded to a line each",
+};
+
+/* Define the batch counters, each on a line of its own even if TM_COUNTER_PADDED is 0.  */
+
+typedef struct tm_false_sharing_batches {
+    rt_align(TM_CACHE_LINE_SIZE) TM_COUNTER counter;
+} tm_false_sharing_batches_t;
+
+static tm_false_sharing_batches_t tm_false_sharing_counter[TM_FALSE_SHARING_MAX_THREADS];
+
+/* Define the counters incremented by the threads, in both layouts.  */
+
+static rt_align(TM_CACHE_LINE_SIZE) volatile unsigned long tm_false_sharing_packed[TM_FALSE_SHARING_MAX_THREADS];
+
+typedef struct tm_false_sharing_slot {
+    rt_align(TM_CACHE_LINE_SIZE) volatile unsigned long value;
+} tm_false_sharing_slot_t;
+
+static tm_false_sharing_slot_t tm_false_sharing_padded[TM_FALSE_SHARING_MAX_THREADS];
+
+/* Define the layout and the number of threads of the current variant.  */
+
+static volatile int tm_false_sharing_layout;
+static int tm_false_sharing_threads;
+
+/* Define the results of each layout.  */
+static unsigned long tm_false_sharing_ops[TM_FALSE_SHARING_LAYOUTS];
+static int tm_false_sharing_status[TM_FALSE_SHARING_LAYOUTS];
+
+/* Define the test thread prototypes.  */
+
+void tm_false_sharing_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_false_sharing_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_false_sharing_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_false_sharing_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_false_sharing_initialize);
+
+    return 0;
+}
+
+/* Define the false sharing thread, one per core.  */
+void tm_false_sharing_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    volatile unsigned long *value = (tm_false_sharing_layout == TM_FALSE_SHARING_PACKED) ?
+                                    &tm_false_sharing_packed[id] : &tm_false_sharing_padded[id].value;
+    int i;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Increment the counter of the thread for a batch.  */
+        for (i = 0; i < TM_FALSE_SHARING_BATCH; i++) {
+            (*value)++;
+        }
+
+        /* Increment the number of batches of the thread.  */
+        tm_counter_increment(&tm_false_sharing_counter[id].counter);
+    }
+}
+
+/* Define the false sharing counter read function, the total of all threads.  */
+static unsigned long long tm_false_sharing_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_false_sharing_threads; i++) {
+        total += tm_counter_read(&tm_false_sharing_counter[i].counter);
+    }
+
+    return total;
+}
+
+/* Measure the counters in the specified layout.  */
+static void tm_false_sharing_variant(int layout)
+{
+    int i;
+
+    /* Create one thread per core at priority 10, bound to its core.  */
+    tm_false_sharing_layout = layout;
+    for (i = 0; i < tm_false_sharing_threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_false_sharing_thread_entry);
+        tm_thread_bind(i, i);
+    }
+    for (i = 0; i < tm_false_sharing_threads; i++) {
+        tm_thread_resume(i);
+    }
+
+    /* Measure the batches for one period, then stop the threads.  */
+    tm_false_sharing_ops[layout] = tm_measure(TM_FALSE_SHARING_ID, tm_false_sharing_counter_read);
+    tm_thread_detach_wait();
+    tm_false_sharing_status[layout] = (tm_false_sharing_ops[layout] != 0) ? TM_SUCCESS : TM_ERROR;
+}
+
+/* Define the false sharing test initialization.  */
+
+void tm_false_sharing_initialize(void)
+{
+    int layout;
+
+    tm_false_sharing_threads = tm_cpu_count();
+    if (tm_false_sharing_threads > TM_FALSE_SHARING_MAX_THREADS) {
+        tm_false_sharing_threads = TM_FALSE_SHARING_MAX_THREADS;
+    }
+
+    for (layout = 0; layout < TM_FALSE_SHARING_LAYOUTS; layout++) {
+        tm_false_sharing_variant(layout);
+    }
+
+    tm_false_sharing_thread_report();
+}
+
+/* Define the false sharing reporting function.  */
+void tm_false_sharing_thread_report(void)
+{
+
+    unsigned long long period_counter;
+    unsigned long long increments;
+    unsigned long ratio;
+    char period_buffer[24];
+    char increments_buffer[24];
+    char core_buffer[24];
+    char buffer[16];
+    int failed;
+    int layout;
+
+    /* Total the increments of all layouts.  */
+    period_counter = 0;
+    failed = 0;
+    for (layout = 0; layout < TM_FALSE_SHARING_LAYOUTS; layout++) {
+        period_counter += (unsigned long long)tm_false_sharing_ops[layout] * TM_FALSE_SHARING_BATCH;
+        failed |= (tm_false_sharing_status[layout] != TM_SUCCESS);
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). False sharing thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_FALSE_SHARING_ID, "a counter thread stopped");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10s | %-10u | %-10lu |\n", "False Sharing Test",
+           tm_measure_format_count(period_buffer, sizeof(period_buffer), period_counter),
+           TM_TEST_DURATION_VALUE * (unsigned int)TM_FALSE_SHARING_LAYOUTS, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  counters", "increments", "per core", "vs packed");
+    for (layout = 0; layout < TM_FALSE_SHARING_LAYOUTS; layout++) {
+
+        /* Show the throughput relative to the packed layout, x100.  */
+        ratio = 0;
+        if (tm_false_sharing_ops[TM_FALSE_SHARING_PACKED] != 0) {
+            ratio = (unsigned long)((unsigned long long)tm_false_sharing_ops[layout] * 100 /
+                                    tm_false_sharing_ops[TM_FALSE_SHARING_PACKED]);
+        }
+
+        increments = (unsigned long long)tm_false_sharing_ops[layout] * TM_FALSE_SHARING_BATCH;
+        printf("|   %-38s | %-10s | %-10s | %-10s |\n", tm_false_sharing_layout_name[layout],
+               tm_measure_format_count(increments_buffer, sizeof(increments_buffer), increments),
+               tm_measure_format_count(core_buffer, sizeof(core_buffer), increments / tm_false_sharing_threads),
+               (tm_false_sharing_status[layout] != TM_SUCCESS) ? "FAILED" : ((ratio != 0) ? tm_measure_format(buffer, sizeof(buffer), ratio) : "-"));
+    }
+    printf("|   %-38s | %-10s | %-10s | %-10s |\n", "test counters of the suite",
+           TM_COUNTER_PADDED ? "padded" : "packed", "", "");
+    tm_measure_report(TM_FALSE_SHARING_ID);
+
+    tm_teardown();
+}
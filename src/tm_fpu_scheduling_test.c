@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * FPU scheduling test. Repeats the cooperative and the preemptive scheduling
+ * tests with every thread doing floating-point work between its switches and
+ * keeping the values live across them, so the switches have to save and
+ * restore the FPU context. Each variant runs for one test period. The report
+ * shows the timestamp counts per operation of the integer-only tests, of the
+ * floating-point variants and their difference.
+ */
+
+#include "tm_api.h"
+
+#define TM_FPU_THREADS 5
+
+TM_COUNTER tm_fpu_thread_counter[TM_FPU_THREADS];
+
+/* Set if a thread found its floating-point values changed across a switch.  */
+static volatile int tm_fpu_corrupted;
+
+/* Define the results of the cooperative and the preemptive variant.  */
+static unsigned long tm_fpu_ops[2];
+static unsigned long long tm_fpu_cost[2];
+
+/* Define the test thread prototypes.  */
+
+void tm_fpu_cooperative_thread_entry(void *p1, void *p2, void *p3);
+void tm_fpu_preemptive_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_fpu_scheduling_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_fpu_scheduling_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_fpu_scheduling_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_fpu_scheduling_initialize);
+
+    return 0;
+}
+
+/* Define the FPU scheduling counter read function.  */
+static unsigned long long tm_fpu_scheduling_counter_total(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    /* Calculate the total of all the counters.  */
+    for (i = 0; i < TM_FPU_THREADS; i++) {
+        total += tm_counter_read(&tm_fpu_thread_counter[i]);
+    }
+
+    return total;
+}
+
+/* Measure the running variant for one period, then delete its threads.  */
+static void tm_fpu_scheduling_measure(int variant)
+{
+    tm_fpu_ops[variant] = tm_measure(TM_FPU_SCHEDULING_ID, tm_fpu_scheduling_counter_total);
+    tm_fpu_cost[variant] = tm_measure_cost(TM_FPU_SCHEDULING_ID);
+    tm_thread_detach_wait();
+}
+
+/* Define the FPU scheduling test initialization.  */
+
+void tm_fpu_scheduling_initialize(void)
+{
+    int i;
+
+    tm_fpu_corrupted = 0;
+
+    /* Create all 5 threads at the same priority as in the cooperative test and resume them.  */
+    for (i = 0; i < TM_FPU_THREADS; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_fpu_cooperative_thread_entry);
+    }
+    for (i = 0; i < TM_FPU_THREADS; i++) {
+        tm_thread_resume(i);
+    }
+    tm_fpu_scheduling_measure(0);
+
+    /* Create the 5 threads at the priorities of the preemptive test and resume just thread 0.  */
+    for (i = 0; i < TM_FPU_THREADS; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 9 - i, tm_fpu_preemptive_thread_entry);
+    }
+    tm_thread_resume(0);
+    tm_fpu_scheduling_measure(1);
+
+    tm_fpu_scheduling_thread_report();
+}
+
+/*
+ * Do the floating-point work of a thread between two switches. The sums
+ * a + b and c + d stay exactly zero unless the values are changed across a
+ * switch; they restart before they lose precision.
+ */
+#define TM_FPU_WORK(a, b, c, d)                                       \
+    do {                                                              \
+        (a) += 1.0f;                                                  \
+        (b) -= 1.0f;                                                  \
+        (c) = (c) * 0.5f + 2.0f;                                      \
+        (d) = (d) * 0.5f - 2.0f;                                      \
+        if (((a) + (b) != 0.0f) || ((c) + (d) != 0.0f)) {             \
+            tm_fpu_corrupted = 1;                                     \
+        }                                                             \
+        if ((a) >= 1048576.0f) {                                      \
+            (a) = 0.0f;                                               \
+            (b) = 0.0f;                                               \
+        }                                                             \
+    } while (0)
+
+/* Define the cooperative threads.  */
+void tm_fpu_cooperative_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    float a = 0.0f, b = 0.0f;
+    float c = (float)id, d = -(float)id;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Relinquish to all other threads at same priority.  */
+        tm_thread_relinquish();
+
+        /* Update the floating-point values that are live across the switch.  */
+        TM_FPU_WORK(a, b, c, d);
+
+        /* Increment this thread's counter.  */
+        tm_counter_increment(&tm_fpu_thread_counter[id]);
+    }
+}
+
+/* Define the preemptive threads, each resumes the next higher priority one and then suspends.  */
+void tm_fpu_preemptive_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    float a = 0.0f, b = 0.0f;
+    float c = (float)id, d = -(float)id;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Resume the next thread, we won't get back here until it and those above it suspend.  */
+        if (id < TM_FPU_THREADS - 1) {
+            tm_thread_resume(id + 1);
+        }
+
+        /* Update the floating-point values that are live across the switch.  */
+        TM_FPU_WORK(a, b, c, d);
+
+        /* Increment this thread's counter.  */
+        tm_counter_increment(&tm_fpu_thread_counter[id]);
+
+        /* Suspend this thread, except the lowest priority one.  */
+        if (id > 0) {
+            tm_thread_suspend(id);
+        }
+    }
+}
+
+/* Show the integer and floating-point cost of one variant.  */
+static void tm_fpu_scheduling_report_row(const char *label, unsigned long long integer, unsigned long long fp)
+{
+    char integer_buffer[16];
+    char fp_buffer[16];
+    char delta_buffer[16];
+
+    /* Show the difference of the two costs with its sign.  */
+    delta_buffer[0] = (fp >= integer) ? '+' : '-';
+    tm_measure_format(delta_buffer + 1, sizeof(delta_buffer) - 1, (fp >= integer) ? (fp - integer) : (integer - fp));
+
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", label,
+           (integer != 0) ? tm_measure_format(integer_buffer, sizeof(integer_buffer), integer) : "-",
+           (fp != 0) ? tm_measure_format(fp_buffer, sizeof(fp_buffer), fp) : "-",
+           ((integer != 0) && (fp != 0)) ? delta_buffer : "-");
+}
+
+/* Define the FPU scheduling reporting function.  */
+void tm_fpu_scheduling_thread_report(void)
+{
+
+    unsigned long period_counter;
+
+    period_counter = tm_fpu_ops[0] + tm_fpu_ops[1];
+
+    /* See if there are any errors.  */
+    if ((tm_fpu_ops[0] == 0) || (tm_fpu_ops[1] == 0)) {
+
+        printf("ERROR: Invalid counter value(s). FPU scheduling thread died!\n");
+    }
+    if (tm_fpu_corrupted) {
+
+        tm_measure_fail(TM_FPU_SCHEDULING_ID, "FP values changed across a switch");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "FPU Scheduling Test", period_counter,
+           TM_TEST_DURATION_VALUE * 2, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  counts/op", "integer", "fpu", "delta");
+    tm_fpu_scheduling_report_row("  cooperative", tm_measure_cost(TM_COOPERATIVE_SCHEDULING_ID), tm_fpu_cost[0]);
+    tm_fpu_scheduling_report_row("  preemptive", tm_measure_cost(TM_PREEMPTIVE_SCHEDULING_ID), tm_fpu_cost[1]);
+    tm_measure_report(TM_FPU_SCHEDULING_ID);
+
+    tm_teardown();
+}
@@ -47,9 +47,9 @@ unsigned int   trap_flag;
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_interrupt_preemption_thread_0_counter;
-unsigned long tm_interrupt_preemption_thread_1_counter;
-unsigned long tm_interrupt_preemption_handler_counter;
+TM_COUNTER tm_interrupt_preemption_thread_0_counter;
+TM_COUNTER tm_interrupt_preemption_thread_1_counter;
+TM_COUNTER tm_interrupt_preemption_handler_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -84,6 +84,11 @@ int tm_interrupt_preemption_processing_main(void)
 void tm_interrupt_preemption_processing_initialize(void)
 {
 
+    /* Clear the counters of a previous run, the report checks them against each other.  */
+    tm_counter_reset(&tm_interrupt_preemption_thread_0_counter);
+    tm_counter_reset(&tm_interrupt_preemption_thread_1_counter);
+    tm_counter_reset(&tm_interrupt_preemption_handler_counter);
+
     /* Create interrupt thread at priority 3.  */
     tm_thread_create(0, 3, tm_interrupt_preemption_thread_0_entry);
 
@@ -110,7 +115,7 @@ void tm_interrupt_preemption_thread_0_entry(void *p1, void *p2, void *p3)
     while (1) {
 
         /* Increment this thread's counter.  */
-        tm_interrupt_preemption_thread_0_counter++;
+        tm_counter_increment(&tm_interrupt_preemption_thread_0_counter);
 
         /*
          * Suspend. This will allow the thread generating the
@@ -144,7 +149,7 @@ void tm_interrupt_preemption_thread_1_entry(void *p1, void *p2, void *p3)
          */
 
         /* Increment this thread's counter.  */
-        tm_interrupt_preemption_thread_1_counter++;
+        tm_counter_increment(&tm_interrupt_preemption_thread_1_counter);
     }
 }
 
@@ -157,50 +162,85 @@ void tm_interrupt_preemption_handler(void)
 {
 
     /* Increment the interrupt count.  */
-    tm_interrupt_preemption_handler_counter++;
+    tm_counter_increment(&tm_interrupt_preemption_handler_counter);
 
     /* Resume the higher priority thread from the ISR.  */
     tm_thread_resume(0);
 }
 
+/* Define the loop skeleton of the interrupt preemption test, with the interrupt and RTOS services stubbed out.  */
+static TM_COUNTER tm_interrupt_preemption_skeleton_counter[3];
+
+static void tm_interrupt_preemption_processing_skeleton(unsigned long iterations)
+{
+    while (iterations--) {
+
+        /* Force an interrupt.  */
+        tm_calibration_stub(0, 0);
+
+        /* Increment the interrupt count and resume the higher priority thread from the handler.  */
+        tm_counter_increment(&tm_interrupt_preemption_skeleton_counter[2]);
+        tm_calibration_stub(0, 0);
+
+        /* The interrupt thread increments its counter and suspends.  */
+        tm_counter_increment(&tm_interrupt_preemption_skeleton_counter[0]);
+        tm_calibration_stub(0, 0);
+
+        /* Increment this thread's counter.  */
+        tm_counter_increment(&tm_interrupt_preemption_skeleton_counter[1]);
+    }
+}
+
+/* Define the interrupt preemption processing test calibration function.  */
+void tm_interrupt_preemption_processing_calibrate(void)
+{
+    tm_calibrate(TM_INTERRUPT_PREEMPTION_PROCESSING_ID, tm_interrupt_preemption_processing_skeleton);
+}
+
+/* Define the interrupt preemption processing counter read function.  */
+static unsigned long long tm_interrupt_preemption_handler_counter_read(void)
+{
+    return tm_counter_read(&tm_interrupt_preemption_handler_counter);
+}
+
 /* Define the interrupt test reporting function.  */
 void tm_interrupt_preemption_thread_report(void)
 {
 
-    unsigned long total;
+    unsigned long long counter[3];
+    unsigned long long total;
+    unsigned long long average;
+    unsigned long period_interrupts;
     unsigned long relative_time;
-    unsigned long last_total;
-    unsigned long average;
-
-    /* Initialize the last total.  */
-    last_total = 0;
 
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_interrupts = tm_measure(TM_INTERRUPT_PREEMPTION_PROCESSING_ID,
+                                       tm_interrupt_preemption_handler_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* Calculate the total of all the counters.  */
-        total = tm_interrupt_preemption_thread_0_counter +
-            tm_interrupt_preemption_thread_1_counter +
-            tm_interrupt_preemption_handler_counter;
+        counter[0] = tm_counter_read(&tm_interrupt_preemption_thread_0_counter);
+        counter[1] = tm_counter_read(&tm_interrupt_preemption_thread_1_counter);
+        counter[2] = tm_counter_read(&tm_interrupt_preemption_handler_counter);
+        total = counter[0] + counter[1] + counter[2];
 
         /* Calculate the average of all the counters.  */
         average = total / 3;
 
         /* See if there are any errors.  */
-        if ((tm_interrupt_preemption_thread_0_counter < (average - 1)) ||
-            (tm_interrupt_preemption_thread_0_counter > (average + 1)) ||
-            (tm_interrupt_preemption_thread_1_counter < (average - 1)) ||
-            (tm_interrupt_preemption_thread_1_counter > (average + 1)) ||
-            (tm_interrupt_preemption_handler_counter < (average - 1)) ||
-            (tm_interrupt_preemption_handler_counter > (average + 1))) {
+        if ((counter[0] < (average - 1)) ||
+            (counter[0] > (average + 1)) ||
+            (counter[1] < (average - 1)) ||
+            (counter[1] > (average + 1)) ||
+            (counter[2] < (average - 1)) ||
+            (counter[2] > (average + 1))) {
 
             printf("ERROR: Invalid counter value(s). Interrupt processing test has "
                    "failed!\n");
@@ -210,11 +250,10 @@ void tm_interrupt_preemption_thread_report(void)
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Interrupt Preemption Processing Test",
-               tm_interrupt_preemption_handler_counter - last_total, relative_time, rt_tick_get());
-        /* Save the last total number of interrupts.  */
-        last_total = tm_interrupt_preemption_handler_counter;
+               period_interrupts, relative_time, rt_tick_get());
+        tm_measure_report(TM_INTERRUPT_PREEMPTION_PROCESSING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
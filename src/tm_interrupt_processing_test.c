@@ -43,8 +43,8 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_interrupt_thread_0_counter;
-unsigned long tm_interrupt_handler_counter;
+TM_COUNTER tm_interrupt_thread_0_counter;
+TM_COUNTER tm_interrupt_handler_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -78,6 +78,10 @@ int tm_interrupt_processing_main(void)
 void tm_interrupt_processing_initialize(void)
 {
 
+    /* Clear the counters of a previous run, the report checks them against each other.  */
+    tm_counter_reset(&tm_interrupt_thread_0_counter);
+    tm_counter_reset(&tm_interrupt_handler_counter);
+
     /* Create thread that generates the interrupt at priority CONFIG_MAIN_THREAD_PRIORITY + 1.  */
     tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_interrupt_thread_0_entry);
 
@@ -132,7 +136,7 @@ void tm_interrupt_thread_0_entry(void *p1, void *p2, void *p3)
         }
 
         /* Increment this thread's counter.  */
-        tm_interrupt_thread_0_counter++;
+        tm_counter_increment(&tm_interrupt_thread_0_counter);
     }
 }
 
@@ -144,46 +148,89 @@ void tm_interrupt_thread_0_entry(void *p1, void *p2, void *p3)
 void tm_interrupt_handler(void)
 {
     /* Increment the interrupt count.  */
-    tm_interrupt_handler_counter++;
+    tm_counter_increment(&tm_interrupt_handler_counter);
 
     /* Put the semaphore from the interrupt handler.  */
     tm_semaphore_put(0);
 }
 
+/* Define the loop skeleton of the interrupt test, with the interrupt and RTOS services stubbed out.  */
+static TM_COUNTER tm_interrupt_skeleton_thread_counter;
+static TM_COUNTER tm_interrupt_skeleton_handler_counter;
+
+static void tm_interrupt_processing_skeleton(unsigned long iterations)
+{
+    int status;
+
+    while (iterations--) {
+
+        /* Force an interrupt.  */
+        tm_calibration_stub(0, 0);
+
+        /* Increment the interrupt count and put the semaphore from the handler.  */
+        tm_counter_increment(&tm_interrupt_skeleton_handler_counter);
+        tm_calibration_stub(0, 0);
+
+        /* Pickup the semaphore set by the interrupt handler. */
+        status = tm_calibration_stub(0, 0);
+
+        /* Check for good status.  */
+        if (status != TM_SUCCESS) {
+            return;
+        }
+
+        /* Increment this thread's counter.  */
+        tm_counter_increment(&tm_interrupt_skeleton_thread_counter);
+    }
+}
+
+/* Define the interrupt processing test calibration function.  */
+void tm_interrupt_processing_calibrate(void)
+{
+    tm_calibrate(TM_INTERRUPT_PROCESSING_ID, tm_interrupt_processing_skeleton);
+}
+
+/* Define the interrupt processing counter read function.  */
+static unsigned long long tm_interrupt_handler_counter_read(void)
+{
+    return tm_counter_read(&tm_interrupt_handler_counter);
+}
+
 /* Define the interrupt test reporting function.  */
 void tm_interrupt_thread_report(void)
 {
 
-    unsigned long total;
-    unsigned long last_total;
+    unsigned long long thread_counter;
+    unsigned long long handler_counter;
+    unsigned long long total;
+    unsigned long long average;
+    unsigned long period_interrupts;
     unsigned long relative_time;
-    unsigned long average;
-
-    /* Initialize the last total.  */
-    last_total = 0;
 
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_interrupts = tm_measure(TM_INTERRUPT_PROCESSING_ID, tm_interrupt_handler_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* Calculate the total of all the counters.  */
-        total = tm_interrupt_thread_0_counter + tm_interrupt_handler_counter;
+        thread_counter = tm_counter_read(&tm_interrupt_thread_0_counter);
+        handler_counter = tm_counter_read(&tm_interrupt_handler_counter);
+        total = thread_counter + handler_counter;
 
         /* Calculate the average of all the counters.  */
         average = total / 2;
 
         /* See if there are any errors.  */
-        if ((tm_interrupt_thread_0_counter < (average - 1)) ||
-            (tm_interrupt_thread_0_counter > (average + 1)) ||
-            (tm_interrupt_handler_counter < (average - 1)) ||
-            (tm_interrupt_handler_counter > (average + 1))) {
+        if ((thread_counter < (average - 1)) ||
+            (thread_counter > (average + 1)) ||
+            (handler_counter < (average - 1)) ||
+            (handler_counter > (average + 1))) {
 
             printf("ERROR: Invalid counter value(s). Interrupt processing test has "
                    "failed!\n");
@@ -193,11 +240,10 @@ void tm_interrupt_thread_report(void)
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Interrupt Processing Test",
-               tm_interrupt_handler_counter - last_total, relative_time, rt_tick_get());
-        /* Save the last total number of interrupts.  */
-        last_total = tm_interrupt_handler_counter;
+               period_interrupts, relative_time, rt_tick_get());
+        tm_measure_report(TM_INTERRUPT_PROCESSING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * IPI latency test, for SMP builds with two cores or more. A waker thread
+ * on core 0 timestamps a wakeup of core 1 every TM_IPI_INTERVAL_TICKS OS
+ * ticks, so the number of wakeups per period scales with RT_TICK_PER_SECOND,
+ * with core 1 either idle or busy running a lower priority thread:
+ *
+ *  - semaphore: the waker releases a semaphore that a higher priority
+ *    thread bound to core 1 is waiting on; the latency ends when that
+ *    thread runs.
+ *  - IPI: the waker sends TM_IPI_VECTOR to core 1 with rt_hw_ipi_send();
+ *    the latency ends when the handler runs on core 1.
+ *
+ * Each variant runs for one test period and keeps a sample of
+ * TM_IPI_SAMPLES latencies drawn uniformly over the whole period, from
+ * which the report shows the median and 99th percentile; the minimum and
+ * maximum are over all latencies, all in timestamp counts. A wakeup not
+ * seen within 10 ms is counted as missed. Each wakeup carries a sequence
+ * number, so that a late one is dropped rather than timed against the
+ * next. The timestamp counter must be common to all cores, as the generic
+ * timer of QEMU virt is.
+ */
+
+#include "tm_api.h"
+#include <stdlib.h>
+
+#if defined(RT_USING_SMP)
+#include <rthw.h>
+
+#define TM_IPI_SAMPLES 1024
+
+/* Define the interval between two wakeups in OS ticks, the finest the waker can sleep.  */
+#define TM_IPI_INTERVAL_TICKS 1
+
+/* Define the variants of the test.  */
+#define TM_IPI_SEMAPHORE 0
+#define TM_IPI_DIRECT    1
+#define TM_IPI_METHODS   2
+
+#define TM_IPI_IDLE      0
+#define TM_IPI_BUSY      1
+#define TM_IPI_TARGETS   2
+
+static const char *tm_ipi_method_name[TM_IPI_METHODS] = {
+    "semaphore",
+    "IPI",
+};
+
+static const char *tm_ipi_target_name[TM_IPI_TARGETS] = {
+    "idle",
+    "busy",
+};
+
+TM_COUNTER tm_ipi_latency_counter;
+TM_COUNTER tm_ipi_latency_busy_counter;
+
+/* Define the semaphore the target thread waits on.  */
+
+static struct rt_semaphore tm_ipi_sem;
+
+/* Define the sequence number and timestamp of the current wakeup, its latency as seen on core 1 and the sequence number acknowledged.  */
+
+static volatile unsigned long tm_ipi_seq;
+static unsigned long long tm_ipi_sent;
+static unsigned long long tm_ipi_latency;
+static volatile unsigned long tm_ipi_ack;
+
+/* Define the method of the current variant and the samples collected by the waker.  */
+
+static volatile int tm_ipi_method;
+static unsigned long tm_ipi_sample[TM_IPI_SAMPLES];
+static unsigned long tm_ipi_samples;
+static unsigned long tm_ipi_min;
+static unsigned long tm_ipi_max;
+static unsigned long tm_ipi_random;
+static unsigned long tm_ipi_missed;
+static int tm_ipi_installed;
+
+/* Define the results of each variant.  */
+
+typedef struct tm_ipi_result {
+    unsigned long ops;
+    unsigned long samples;
+    unsigned long missed;
+    unsigned long min;
+    unsigned long median;
+    unsigned long p99;
+    unsigned long max;
+} tm_ipi_result_t;
+
+static tm_ipi_result_t tm_ipi_result[TM_IPI_METHODS][TM_IPI_TARGETS];
+static int tm_ipi_cores;
+
+/* Define the test thread prototypes.  */
+
+void tm_ipi_latency_thread_0_entry(void *p1, void *p2, void *p3);
+void tm_ipi_latency_thread_1_entry(void *p1, void *p2, void *p3);
+void tm_ipi_latency_thread_2_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_ipi_latency_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_ipi_latency_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_ipi_latency_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_ipi_latency_initialize);
+
+    return 0;
+}
+
+/*
+ * Record the latency of the specified wakeup on core 1 and acknowledge it.
+ * A wakeup other than the current one comes after the waker gave up on it,
+ * it is dropped rather than timed against the timestamp of the current one.
+ */
+static void tm_ipi_latency_record(unsigned long seq)
+{
+    unsigned long long now = tm_timestamp_get();
+
+    if (seq != __atomic_load_n(&tm_ipi_seq, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    tm_ipi_latency = now - tm_ipi_sent;
+    __atomic_store_n(&tm_ipi_ack, seq, __ATOMIC_RELEASE);
+}
+
+/* Define the IPI handler, run on core 1.  */
+static void tm_ipi_latency_handler(int vector, void *param)
+{
+    (void)vector;
+    (void)param;
+
+    /* An IPI carries no sequence number, the waker sends the next one only once this one ran.  */
+    tm_ipi_latency_record(__atomic_load_n(&tm_ipi_seq, __ATOMIC_ACQUIRE));
+}
+
+/*
+ * Wait up to 10 ms for core 1 to acknowledge the specified wakeup.
+ * Returns TM_SUCCESS if it did, TM_ERROR otherwise.
+ */
+static int tm_ipi_latency_wait(unsigned long seq)
+{
+    unsigned long long deadline = tm_timestamp_get() + tm_timestamp_frequency() / 100;
+
+    while (__atomic_load_n(&tm_ipi_ack, __ATOMIC_ACQUIRE) != seq) {
+        if (tm_timestamp_get() > deadline) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+/*
+ * Keep a latency in the samples. The first TM_IPI_SAMPLES latencies fill
+ * the samples, then the n-th one replaces a random sample with probability
+ * TM_IPI_SAMPLES / n (reservoir sampling), so that the samples are drawn
+ * uniformly over the whole period. The minimum and maximum are exact.
+ */
+static void tm_ipi_latency_keep(unsigned long latency)
+{
+    unsigned long index;
+
+    if ((tm_ipi_samples == 0) || (latency < tm_ipi_min)) {
+        tm_ipi_min = latency;
+    }
+    if (latency > tm_ipi_max) {
+        tm_ipi_max = latency;
+    }
+
+    index = tm_ipi_samples;
+    if (index >= TM_IPI_SAMPLES) {
+
+        /* Advance a 32-bit xorshift generator and pick one of the latencies seen so far.  */
+        tm_ipi_random ^= (tm_ipi_random << 13) & 0xFFFFFFFFUL;
+        tm_ipi_random ^= tm_ipi_random >> 17;
+        tm_ipi_random ^= (tm_ipi_random << 5) & 0xFFFFFFFFUL;
+        index = tm_ipi_random % (tm_ipi_samples + 1);
+    }
+    if (index < TM_IPI_SAMPLES) {
+        tm_ipi_sample[index] = latency;
+    }
+    tm_ipi_samples++;
+}
+
+/* Define the waker thread, bound to core 0.  */
+void tm_ipi_latency_thread_0_entry(void *p1, void *p2, void *p3)
+{
+    int method = tm_ipi_method;
+    unsigned long seq = 0;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Let core 1 settle, then timestamp and send the next wakeup.  */
+        rt_thread_delay(TM_IPI_INTERVAL_TICKS);
+        seq++;
+        tm_ipi_sent = tm_timestamp_get();
+        __atomic_store_n(&tm_ipi_seq, seq, __ATOMIC_RELEASE);
+        if (method == TM_IPI_SEMAPHORE) {
+            rt_sem_release(&tm_ipi_sem);
+        } else {
+            rt_hw_ipi_send(TM_IPI_VECTOR, 1U << 1);
+        }
+
+        /* Keep the latency, or count the wakeup as missed.  */
+        if (tm_ipi_latency_wait(seq) == TM_SUCCESS) {
+            tm_ipi_latency_keep((unsigned long)tm_ipi_latency);
+        } else {
+            tm_ipi_missed++;
+
+            /* A late IPI would be taken for the next one, wait until its handler ran.  */
+            while ((method == TM_IPI_DIRECT) && (__atomic_load_n(&tm_ipi_ack, __ATOMIC_ACQUIRE) != seq)) {
+            }
+        }
+
+        /* Increment the number of wakeups.  */
+        tm_counter_increment(&tm_ipi_latency_counter);
+    }
+}
+
+/* Define the target thread, bound to core 1.  */
+void tm_ipi_latency_thread_1_entry(void *p1, void *p2, void *p3)
+{
+    unsigned long taken = 0;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    /* Enable the IPI on this core, it is only handled in interrupt context.  */
+    if (tm_ipi_method == TM_IPI_DIRECT) {
+        rt_hw_interrupt_umask(TM_IPI_VECTOR);
+        while (1) {
+            tm_thread_suspend(1);
+        }
+    }
+
+    while (1) {
+
+        /* Wait for the waker, then record when this thread runs. The n-th take is the n-th release.  */
+        rt_sem_take(&tm_ipi_sem, RT_WAITING_FOREVER);
+        tm_ipi_latency_record(++taken);
+    }
+}
+
+/* Define the thread keeping core 1 busy at a lower priority than the target thread.  */
+void tm_ipi_latency_thread_2_entry(void *p1, void *p2, void *p3)
+{
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+        tm_counter_increment(&tm_ipi_latency_busy_counter);
+    }
+}
+
+/* Define the IPI latency counter read function.  */
+static unsigned long long tm_ipi_latency_counter_read(void)
+{
+    return tm_counter_read(&tm_ipi_latency_counter);
+}
+
+/* Compare two latencies for qsort().  */
+static int tm_ipi_latency_compare(const void *a, const void *b)
+{
+    unsigned long x = *(const unsigned long *)a;
+    unsigned long y = *(const unsigned long *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Measure one wakeup method with core 1 idle or busy.  */
+static void tm_ipi_latency_variant(int method, int target)
+{
+    tm_ipi_result_t *result = &tm_ipi_result[method][target];
+    unsigned long samples;
+
+    rt_sem_init(&tm_ipi_sem, "tm_ipi", 0, RT_IPC_FLAG_PRIO);
+    if ((method == TM_IPI_DIRECT) && !tm_ipi_installed) {
+        rt_hw_ipi_handler_install(TM_IPI_VECTOR, tm_ipi_latency_handler);
+        tm_ipi_installed = 1;
+    }
+    tm_ipi_method = method;
+    tm_ipi_seq = 0;
+    tm_ipi_ack = 0;
+    tm_ipi_samples = 0;
+    tm_ipi_min = 0;
+    tm_ipi_max = 0;
+    tm_ipi_random = 0x12345678;
+    tm_ipi_missed = 0;
+
+    /* Create the target thread on core 1 above the busy thread, and the waker on core 0.  */
+    tm_thread_create(1, CONFIG_MAIN_THREAD_PRIORITY, tm_ipi_latency_thread_1_entry);
+    tm_thread_bind(1, 1);
+    tm_thread_resume(1);
+    if (target == TM_IPI_BUSY) {
+        tm_thread_create(2, CONFIG_MAIN_THREAD_PRIORITY + 2, tm_ipi_latency_thread_2_entry);
+        tm_thread_bind(2, 1);
+        tm_thread_resume(2);
+    }
+    tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_ipi_latency_thread_0_entry);
+    tm_thread_bind(0, 0);
+    tm_thread_resume(0);
+
+    /* Measure the wakeups for one period, then stop the threads.  */
+    result->ops = tm_measure(TM_IPI_LATENCY_ID, tm_ipi_latency_counter_read);
+    tm_thread_detach_wait();
+    rt_sem_detach(&tm_ipi_sem);
+
+    /* Sort the kept latencies and take their distribution.  */
+    samples = (tm_ipi_samples < TM_IPI_SAMPLES) ? tm_ipi_samples : TM_IPI_SAMPLES;
+    result->samples = tm_ipi_samples;
+    result->missed = tm_ipi_missed;
+    if (samples != 0) {
+        qsort(tm_ipi_sample, samples, sizeof(tm_ipi_sample[0]), tm_ipi_latency_compare);
+        result->min = tm_ipi_min;
+        result->median = tm_ipi_sample[samples / 2];
+        result->p99 = tm_ipi_sample[samples * 99 / 100];
+        result->max = tm_ipi_max;
+    }
+}
+
+/* Define the IPI latency test initialization.  */
+
+void tm_ipi_latency_initialize(void)
+{
+    int method;
+    int target;
+
+    tm_ipi_cores = tm_cpu_count();
+    for (method = 0; (method < TM_IPI_METHODS) && (tm_ipi_cores > 1); method++) {
+        for (target = 0; target < TM_IPI_TARGETS; target++) {
+            tm_ipi_latency_variant(method, target);
+        }
+    }
+
+    tm_ipi_latency_thread_report();
+}
+
+/* Define the IPI latency reporting function.  */
+void tm_ipi_latency_thread_report(void)
+{
+
+    unsigned long period_counter;
+    tm_ipi_result_t *result;
+    char label[48];
+    int failed;
+    int method;
+    int target;
+
+    /* Total the wakeups of all variants.  */
+    period_counter = 0;
+    failed = (tm_ipi_cores < 2);
+    for (method = 0; (method < TM_IPI_METHODS) && (tm_ipi_cores > 1); method++) {
+        for (target = 0; target < TM_IPI_TARGETS; target++) {
+            period_counter += tm_ipi_result[method][target].ops;
+            failed |= (tm_ipi_result[method][target].samples == 0);
+        }
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). IPI latency thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_IPI_LATENCY_ID, (tm_ipi_cores < 2) ? "needs two cores" : "core 1 never woke up");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "IPI Latency Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)((tm_ipi_cores > 1) ? TM_IPI_METHODS * TM_IPI_TARGETS : 0),
+           rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  wakeup, core 1", "min", "median", "99th pct");
+    for (method = 0; (method < TM_IPI_METHODS) && (tm_ipi_cores > 1); method++) {
+        for (target = 0; target < TM_IPI_TARGETS; target++) {
+            result = &tm_ipi_result[method][target];
+            snprintf(label, sizeof(label), "%s, %s", tm_ipi_method_name[method], tm_ipi_target_name[target]);
+            printf("|   %-38s | %-10lu | %-10lu | %-10lu |\n", label, result->min, result->median, result->p99);
+            printf("|   %-38s | %-10lu | %-10lu | %-10lu |\n", "  max, samples, missed", result->max,
+                   result->samples, result->missed);
+        }
+    }
+    tm_measure_report(TM_IPI_LATENCY_ID);
+
+    tm_teardown();
+}
+
+#else
+
+/* Define main entry point, the test needs an SMP build.  */
+
+int tm_ipi_latency_main(void)
+{
+    return 0;
+}
+
+#endif
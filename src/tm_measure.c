@@ -0,0 +1,671 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Measurement helpers shared by the testcases. A test reporter calls
+ * tm_measure() instead of sleeping for the test period itself, then prints
+ * its row and calls tm_measure_report() for any additional rows.
+ */
+
+#include "tm_api.h"
+
+/* Define the measurement record of each test.  */
+typedef struct tm_measurement
+{
+    unsigned long       ops;
+    unsigned long long  elapsed;
+    unsigned long       warmup_ms;
+    unsigned long       cold_ops;
+    unsigned long long  cold_elapsed;
+    unsigned long long  overhead;       /* harness timestamp counts per op, x100 */
+    int                 calibrated;
+    unsigned long       windows;
+    unsigned long       interval;       /* relative 95% confidence interval, in 0.01% */
+    int                 converged;
+    int                 measured;
+    int                 failed;
+    const char         *reason;
+    rt_tick_t           tick;
+} tm_measurement_t;
+
+static tm_measurement_t tm_measurement[CONFIG_TESTCASE_NUM];
+static int tm_measurement_initialized;
+
+/* Define the name of each test, indexed by its identifier.  */
+static const char *tm_measure_name[CONFIG_TESTCASE_NUM] =
+{
+    "Basic Single Thread Processing Test",
+    "Cooperative Scheduling Test",
+    "Preemptive Scheduling Test",
+    "Interrupt Processing Test",
+    "Interrupt Preemption Processing Test",
+    "Message Processing Test",
+    "Synchronization Processing Test",
+    "Memory Allocation Test",
+    "Compute Processing Test",
+    "Parallel Processing Test",
+    "Memory Bandwidth Test",
+    "FPU Scheduling Test",
+    "Queue Comparison Test",
+    "Pool Comparison Test",
+    "Semaphore Comparison Test",
+    "Atomic Operations Test",
+    "Spinlock Test",
+    "IPI Latency Test",
+    "Thread Migration Test",
+    "False Sharing Test",
+};
+
+/* Define the test currently being measured, -1 if none.  */
+static volatile int tm_measure_current = -1;
+
+#if TM_TIME_SERIES_ENABLE
+/* Define the time series of the test being measured.  */
+static unsigned long long tm_time_series_counter[TM_TIME_SERIES_MAX_SAMPLES];
+static unsigned long long tm_time_series_time[TM_TIME_SERIES_MAX_SAMPLES];
+static volatile int tm_time_series_samples;
+#endif
+
+#if TM_TIME_SERIES_ENABLE || TM_WATCHDOG_ENABLE
+#define TM_MEASURE_SAMPLER 1
+#else
+#define TM_MEASURE_SAMPLER 0
+#endif
+
+#if TM_TIME_SERIES_ENABLE
+#define TM_MEASURE_SAMPLER_PRIORITY  TM_TIME_SERIES_PRIORITY
+#define TM_MEASURE_SAMPLER_PERIOD_MS TM_TIME_SERIES_PERIOD_MS
+#else
+#define TM_MEASURE_SAMPLER_PRIORITY  TM_WATCHDOG_PRIORITY
+#define TM_MEASURE_SAMPLER_PERIOD_MS ((TM_WATCHDOG_TIMEOUT_MS + 3) / 4)
+#endif
+
+#if TM_MEASURE_SAMPLER
+/* Define the test being sampled.  */
+static tm_measurement_t *tm_sample_measurement;
+static unsigned long long (*tm_sample_counter_read)(void);
+
+#if TM_WATCHDOG_ENABLE
+/* Define the last progress seen by the watchdog.  */
+static unsigned long long tm_watchdog_counter;
+static unsigned long long tm_watchdog_time;
+static unsigned long long tm_watchdog_timeout;
+
+/* Define the signal of a failure to the measuring thread, and whether it is armed.  */
+static struct rt_semaphore tm_watchdog_signal;
+static int tm_watchdog_armed;
+#endif
+
+/* This function is called by the sampler thread while a test is measured.  */
+static void tm_measure_sample(void)
+{
+    unsigned long long counter = tm_sample_counter_read();
+    unsigned long long now = tm_timestamp_get();
+#if TM_TIME_SERIES_ENABLE
+    int index = tm_time_series_samples;
+
+    if (index < TM_TIME_SERIES_MAX_SAMPLES)
+    {
+        tm_time_series_time[index] = now;
+        tm_time_series_counter[index] = counter;
+        tm_time_series_samples = index + 1;
+    }
+#endif
+
+#if TM_WATCHDOG_ENABLE
+    if (counter != tm_watchdog_counter)
+    {
+        tm_watchdog_counter = counter;
+        tm_watchdog_time = now;
+    }
+    else if ((tm_sample_measurement->failed == 0) && (now - tm_watchdog_time >= tm_watchdog_timeout))
+    {
+        /* The test is stuck, wake the measuring thread, which deletes the test threads.  */
+        tm_sample_measurement->reason = "no progress within watchdog timeout";
+        tm_sample_measurement->failed = 1;
+        rt_sem_release(&tm_watchdog_signal);
+    }
+#endif
+}
+#endif
+
+/* Sleep for the specified time, returning early once the test has failed if the watchdog is enabled.  */
+static void tm_measure_sleep(tm_measurement_t *m, unsigned long milliseconds)
+{
+#if TM_WATCHDOG_ENABLE
+    if (tm_watchdog_armed && (m == tm_sample_measurement))
+    {
+        if (m->failed == 0)
+        {
+            rt_sem_take(&tm_watchdog_signal, rt_tick_from_millisecond(milliseconds));
+        }
+        return;
+    }
+#endif
+
+    (void)m;
+    tm_thread_sleep_ms(milliseconds);
+}
+
+/* Apply the configured defaults to the measurement records once.  */
+static void tm_measure_initialize(void)
+{
+    int i;
+
+    if (tm_measurement_initialized)
+    {
+        return;
+    }
+
+    for (i = 0; i < CONFIG_TESTCASE_NUM; i++)
+    {
+        tm_measurement[i].warmup_ms = TM_TEST_WARMUP_MS;
+    }
+#if TM_WATCHDOG_ENABLE
+    /* Keep the signal for good, a failing test thread may still post it after the measurement.  */
+    rt_sem_init(&tm_watchdog_signal, "tm_wdog", 0, RT_IPC_FLAG_PRIO);
+#endif
+    tm_measurement_initialized = 1;
+}
+
+/* Convert a number of operations over a number of timestamp counts to operations per ms, x100.  */
+static unsigned long long tm_measure_ops_per_ms(unsigned long ops, unsigned long long elapsed)
+{
+    if (elapsed == 0)
+    {
+        return 0;
+    }
+
+    return (unsigned long long)ops * tm_timestamp_frequency() / (elapsed * 10);
+}
+
+#if TM_ADAPTIVE_ENABLE
+/* Define the operations of each adaptive window.  */
+static unsigned long tm_adaptive_window[TM_ADAPTIVE_MAX_WINDOWS];
+
+/* Two-sided 95% Student t values, x1000, indexed by the degrees of freedom.  */
+static const unsigned short tm_adaptive_t[] =
+{
+    0,    12706, 4303, 3182, 2776, 2571, 2447, 2365, 2306, 2262,
+    2228, 2201,  2179, 2160, 2145, 2131, 2120, 2110, 2101, 2093,
+    2086, 2080,  2074, 2069, 2064, 2060, 2056, 2052, 2048, 2045,
+    2042
+};
+
+/* Integer square root.  */
+static unsigned long long tm_adaptive_sqrt(unsigned long long value)
+{
+    unsigned long long result = 0;
+    unsigned long long bit = 1ULL << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return result;
+}
+
+/*
+ * This function returns the half width of the 95% confidence interval of the
+ * mean of the first n windows, relative to the mean, in units of 0.01%.
+ */
+static unsigned long tm_adaptive_interval(unsigned long n)
+{
+    unsigned long long sum = 0;
+    unsigned long long mean;
+    unsigned long long deviation;
+    unsigned long long variance = 0;
+    unsigned long t;
+    unsigned long i;
+
+    if (n < 2)
+    {
+        return ~0UL;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        sum += tm_adaptive_window[i];
+    }
+    mean = sum / n;
+    if (mean == 0)
+    {
+        return ~0UL;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        deviation = (tm_adaptive_window[i] > mean) ? (tm_adaptive_window[i] - mean) : (mean - tm_adaptive_window[i]);
+        variance += deviation * deviation;
+    }
+    variance = variance / (n - 1);
+
+    t = (n - 1 < sizeof(tm_adaptive_t) / sizeof(tm_adaptive_t[0])) ? tm_adaptive_t[n - 1] : 1960;
+
+    /* t * sqrt(variance / n) / mean * 10000, with the standard error kept x10.  */
+    return (unsigned long)(t * tm_adaptive_sqrt(variance * 100 / n) / mean);
+}
+
+/*
+ * This function adds measurement windows until the confidence interval
+ * converges or a cap is hit, and returns the total number of operations.
+ */
+static unsigned long tm_adaptive_measure(tm_measurement_t *m, unsigned long long (*counter_read)(void))
+{
+    unsigned long total = 0;
+    unsigned long long start_counter;
+    unsigned long long counter;
+    unsigned long elapsed_ms = 0;
+
+    m->windows = 0;
+    m->converged = 0;
+    m->interval = ~0UL;
+
+    start_counter = counter_read();
+    while ((m->windows < TM_ADAPTIVE_MAX_WINDOWS) && (elapsed_ms < TM_ADAPTIVE_TIME_CAP_MS))
+    {
+        tm_measure_sleep(m, TM_ADAPTIVE_WINDOW_MS);
+        elapsed_ms += TM_ADAPTIVE_WINDOW_MS;
+        if (m->failed)
+        {
+            break;
+        }
+
+        counter = counter_read();
+        tm_adaptive_window[m->windows] = (unsigned long)(counter - start_counter);
+        total += tm_adaptive_window[m->windows++];
+        start_counter = counter;
+
+        if (m->windows >= TM_ADAPTIVE_MIN_WINDOWS)
+        {
+            m->interval = tm_adaptive_interval(m->windows);
+            if (m->interval <= TM_ADAPTIVE_TARGET)
+            {
+                m->converged = 1;
+                break;
+            }
+        }
+    }
+
+    return total;
+}
+#endif
+
+/* Format a value scaled by 100 as a fixed-point number.  */
+const char *tm_measure_format(char *buffer, int size, unsigned long long value)
+{
+    snprintf(buffer, size, "%lu.%02lu", (unsigned long)(value / 100), (unsigned long)(value % 100));
+    return buffer;
+}
+
+/* Format a 64-bit count, in two parts as the printf of the target may lack %llu.  */
+const char *tm_measure_format_count(char *buffer, int size, unsigned long long value)
+{
+    if (value < 1000000000ULL)
+    {
+        snprintf(buffer, size, "%lu", (unsigned long)value);
+    }
+    else
+    {
+        snprintf(buffer, size, "%lu%09lu", (unsigned long)(value / 1000000000ULL),
+                 (unsigned long)(value % 1000000000ULL));
+    }
+    return buffer;
+}
+
+/*
+ * This function sets the warm-up period of a test in milliseconds.
+ */
+void tm_measure_warmup(int test_id, unsigned long milliseconds)
+{
+    tm_measure_initialize();
+    tm_measurement[test_id].warmup_ms = milliseconds;
+}
+
+/*
+ * This function measures a test for one period and returns the number of
+ * operations counted by counter_read() during the period. The operations
+ * of the warm-up period, if any, are recorded separately.
+ */
+unsigned long tm_measure(int test_id, unsigned long long (*counter_read)(void))
+{
+    tm_measurement_t *m;
+    unsigned long long start_counter;
+    unsigned long long start_time;
+    unsigned long long counter;
+    unsigned long long now;
+#if TM_MEASURE_SAMPLER
+    int sampled;
+#endif
+
+    tm_measure_initialize();
+    m = &tm_measurement[test_id];
+    m->failed = 0;
+    m->reason = RT_NULL;
+    tm_measure_current = test_id;
+
+#if TM_MEASURE_SAMPLER
+    /* Record the first sample and start the sampler, unless several tests run at once.  */
+#if TM_TIME_SERIES_ENABLE
+    tm_time_series_samples = 0;
+#endif
+    sampled = !tm_concurrent_running();
+    if (sampled)
+    {
+        tm_sample_measurement = m;
+        tm_sample_counter_read = counter_read;
+#if TM_WATCHDOG_ENABLE
+        tm_watchdog_timeout = tm_timestamp_frequency() * TM_WATCHDOG_TIMEOUT_MS / 1000;
+        tm_watchdog_counter = ~0ULL;
+        rt_sem_control(&tm_watchdog_signal, RT_IPC_CMD_RESET, (void *)0);
+        tm_watchdog_armed = 1;
+#endif
+        tm_measure_sample();
+        tm_sampler_start(TM_MEASURE_SAMPLER_PRIORITY, TM_MEASURE_SAMPLER_PERIOD_MS, tm_measure_sample);
+    }
+#endif
+
+    start_counter = counter_read();
+    start_time = tm_timestamp_get();
+
+    /* Let the test warm up, then restart the measurement.  */
+    if (m->warmup_ms != 0)
+    {
+        tm_measure_sleep(m, m->warmup_ms);
+
+        now = tm_timestamp_get();
+        counter = counter_read();
+        m->cold_ops = (unsigned long)(counter - start_counter);
+        m->cold_elapsed = now - start_time;
+
+        start_counter = counter;
+        start_time = now;
+    }
+
+#if TM_ADAPTIVE_ENABLE
+    m->ops = tm_adaptive_measure(m, counter_read);
+    m->elapsed = tm_timestamp_get() - start_time;
+#else
+    /* Sleep to allow the test to run.  */
+    tm_measure_sleep(m, TM_TEST_DURATION_VALUE * 1000);
+
+    m->elapsed = tm_timestamp_get() - start_time;
+    m->ops = (unsigned long)(counter_read() - start_counter);
+#endif
+
+#if TM_MEASURE_SAMPLER
+    if (sampled)
+    {
+        tm_sampler_stop();
+#if TM_WATCHDOG_ENABLE
+        tm_watchdog_armed = 0;
+
+        /* Delete the threads of a stuck or failed test here, so that the reporter can tear it down.  */
+        if (m->failed)
+        {
+            tm_thread_detach();
+        }
+#endif
+    }
+#endif
+
+    m->measured = 1;
+    m->tick = rt_tick_get();
+    tm_measure_current = -1;
+
+#if TM_ADAPTIVE_ENABLE
+    /* Scale the mean of the windows to the test period.  */
+    if (m->windows == 0)
+    {
+        return 0;
+    }
+    return (unsigned long)((unsigned long long)m->ops * TM_TEST_DURATION_VALUE * 1000 /
+                           (m->windows * TM_ADAPTIVE_WINDOW_MS));
+#else
+    return m->ops;
+#endif
+}
+
+/* This function prints the additional report rows of a measured test.  */
+void tm_measure_report(int test_id)
+{
+    tm_measurement_t *m = &tm_measurement[test_id];
+    unsigned long long gross;
+    unsigned long long net;
+    char gross_buffer[16];
+    char overhead_buffer[16];
+    char net_buffer[16];
+
+    if (m->failed)
+    {
+        /* Show why the test was stopped, its other rows would be meaningless.  */
+        printf("| %-40s | %-36.36s |\n", "  FAILED", m->reason);
+        return;
+    }
+
+    if (m->warmup_ms != 0)
+    {
+        /* Show the cold and warm throughput side by side.  */
+        printf("| %-40s | %-10lu | %-10s | %-10s |\n", "  ops/ms: warm-up ms, cold, warm", m->warmup_ms,
+               tm_measure_format(gross_buffer, sizeof(gross_buffer), tm_measure_ops_per_ms(m->cold_ops, m->cold_elapsed)),
+               tm_measure_format(net_buffer, sizeof(net_buffer), tm_measure_ops_per_ms(m->ops, m->elapsed)));
+    }
+
+#if TM_ADAPTIVE_ENABLE
+    /* Show the number of windows and the relative confidence interval in percent.  */
+    printf("| %-40s | %-10lu | %-10s | %-10s |\n", "  adaptive: windows, 95% CI %, converged", m->windows,
+           (m->interval == ~0UL) ? "-" : tm_measure_format(net_buffer, sizeof(net_buffer), m->interval),
+           m->converged ? "yes" : "cap");
+#endif
+
+#if TM_TIME_SERIES_ENABLE
+    if (tm_time_series_samples > 1)
+    {
+        int i;
+        unsigned long long frequency = tm_timestamp_frequency();
+        unsigned long delta;
+
+        /* Show the operations and throughput of each sample interval.  */
+        printf("| %-40s | %-10s | %-10s | %-10s |\n", "  time series", "ms", "ops", "ops/ms");
+        for (i = 1; i < tm_time_series_samples; i++)
+        {
+            delta = (unsigned long)(tm_time_series_counter[i] - tm_time_series_counter[i - 1]);
+            printf("| %-40s | %-10lu | %-10lu | %-10s |\n", "",
+                   (unsigned long)((tm_time_series_time[i] - tm_time_series_time[0]) * 1000 / frequency),
+                   delta,
+                   tm_measure_format(net_buffer, sizeof(net_buffer),
+                                     tm_measure_ops_per_ms(delta, tm_time_series_time[i] - tm_time_series_time[i - 1])));
+        }
+    }
+#endif
+
+    if ((m->calibrated == 0) || (m->ops == 0))
+    {
+        return;
+    }
+
+    /* Subtract the harness overhead of the loop skeleton from the measured cost.  */
+    gross = m->elapsed * 100 / m->ops;
+    net = (gross > m->overhead) ? (gross - m->overhead) : 0;
+
+    tm_measure_report_frequency();
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  counts/op: gross, harness, net",
+           tm_measure_format(gross_buffer, sizeof(gross_buffer), gross),
+           tm_measure_format(overhead_buffer, sizeof(overhead_buffer), m->overhead),
+           tm_measure_format(net_buffer, sizeof(net_buffer), net));
+}
+
+/*
+ * This function prints the frequency of the timestamp counter, the unit of
+ * the counts/op rows. The counts are core cycles only with a cycle counter.
+ */
+void tm_measure_report_frequency(void)
+{
+    printf("| %-40s | %-10lu | %-10s | %-10s |\n", "  timestamp Hz", tm_timestamp_frequency(), "", "");
+}
+
+/* This function prints the test currently being measured.  */
+void tm_measure_status(void)
+{
+    int test_id = tm_measure_current;
+
+    if (test_id >= 0)
+    {
+        printf("measuring: %s\n", tm_measure_name[test_id]);
+    }
+}
+
+/* This function prints the latest result of every measured test.  */
+void tm_measure_summary(void)
+{
+    tm_measurement_t *m;
+    char buffer[16];
+    int i;
+
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("|                  TESTCASE                |period total|   ops/ms   |   os tick  |\n");
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    for (i = 0; i < CONFIG_TESTCASE_NUM; i++)
+    {
+        m = &tm_measurement[i];
+        if (m->measured == 0)
+        {
+            continue;
+        }
+
+        printf("| %-40s | %-10lu | %-10s | %-10lu |\n", tm_measure_name[i], m->ops,
+               m->failed ? "FAILED" : tm_measure_format(buffer, sizeof(buffer), tm_measure_ops_per_ms(m->ops, m->elapsed)),
+               (unsigned long)m->tick);
+    }
+    printf("+------------------------------------------+------------+------------+------------+\n");
+}
+
+/*
+ * This function returns the timestamp counts per operation, x100, of the last
+ * measurement of the test, or 0 if it has not been measured.
+ */
+unsigned long long tm_measure_cost(int test_id)
+{
+    tm_measurement_t *m = &tm_measurement[test_id];
+
+    if ((m->measured == 0) || (m->ops == 0))
+    {
+        return 0;
+    }
+
+    return m->elapsed * 100 / m->ops;
+}
+
+/*
+ * This function returns the operations per ms, x100, of the last measurement
+ * of the test, or 0 if it has not been measured or failed.
+ */
+unsigned long long tm_measure_throughput(int test_id)
+{
+    tm_measurement_t *m = &tm_measurement[test_id];
+
+    if ((m->measured == 0) || m->failed)
+    {
+        return 0;
+    }
+
+    return tm_measure_ops_per_ms(m->ops, m->elapsed);
+}
+
+/* This function returns the name of the test.  */
+const char *tm_measure_test_name(int test_id)
+{
+    return tm_measure_name[test_id];
+}
+
+/*
+ * This function marks the test as FAILED with the specified reason. It may be
+ * called from the test threads while the test is measured; with the watchdog
+ * enabled that ends the measurement early.
+ */
+void tm_measure_fail(int test_id, const char *reason)
+{
+    tm_measurement_t *m = &tm_measurement[test_id];
+
+    if (m->failed == 0)
+    {
+        m->reason = reason;
+        m->failed = 1;
+
+#if TM_WATCHDOG_ENABLE
+        /* End the measurement of the test early, as the watchdog does.  */
+        if (tm_watchdog_armed && (m == tm_sample_measurement))
+        {
+            rt_sem_release(&tm_watchdog_signal);
+        }
+#endif
+    }
+}
+
+/*
+ * This function times the loop skeleton of a test, i.e. its loop with the RTOS
+ * services replaced by tm_calibration_stub(). The skeleton runs the given
+ * number of operations; the fastest of TM_CALIBRATION_ROUNDS rounds is kept.
+ */
+void tm_calibrate(int test_id, void (*skeleton)(unsigned long iterations))
+{
+    tm_measurement_t *m = &tm_measurement[test_id];
+    unsigned long long start_time;
+    unsigned long long elapsed;
+    unsigned long long best;
+    int round;
+
+    best = ~0ULL;
+    for (round = 0; round < TM_CALIBRATION_ROUNDS; round++)
+    {
+        start_time = tm_timestamp_get();
+        skeleton(TM_CALIBRATION_ITERATIONS);
+        elapsed = tm_timestamp_get() - start_time;
+
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    m->overhead = best * 100 / TM_CALIBRATION_ITERATIONS;
+    m->calibrated = 1;
+}
+
+/* This function runs the calibration phase for all tests.  */
+void tm_calibration_main(void)
+{
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("| %-40s | %-10lu | %-10s | %-10s |\n", "Calibration (timestamp Hz)",
+           tm_timestamp_frequency(), "", "");
+
+    tm_cooperative_scheduling_calibrate();
+    tm_preemptive_scheduling_calibrate();
+    tm_interrupt_processing_calibrate();
+    tm_interrupt_preemption_processing_calibrate();
+    tm_message_processing_calibrate();
+    tm_synchronization_processing_calibrate();
+    tm_memory_allocation_calibrate();
+}
@@ -43,7 +43,7 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_memory_allocation_counter;
+TM_COUNTER tm_memory_allocation_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -104,33 +104,68 @@ void tm_memory_allocation_thread_0_entry(void *p1, void *p2, void *p3)
         }
 
         /* Increment the number of memory allocations sent and received.  */
-        tm_memory_allocation_counter++;
+        tm_counter_increment(&tm_memory_allocation_counter);
     }
 }
 
+/* Define the loop skeleton of the memory allocation thread, with the RTOS services stubbed out.  */
+static TM_COUNTER tm_memory_allocation_skeleton_counter;
+
+static void tm_memory_allocation_skeleton(unsigned long iterations)
+{
+    int status;
+    unsigned char *memory_ptr = 0;
+
+    while (iterations--) {
+
+        /* Allocate memory from pool.  */
+        tm_calibration_stub(0, &memory_ptr);
+
+        /* Release the memory back to the pool.  */
+        status = tm_calibration_stub(0, memory_ptr);
+
+        /* Check for invalid memory allocation/deallocation.  */
+        if (status != TM_SUCCESS) {
+            break;
+        }
+
+        /* Increment the number of memory allocations sent and received.  */
+        tm_counter_increment(&tm_memory_allocation_skeleton_counter);
+    }
+}
+
+/* Define the memory allocation test calibration function.  */
+void tm_memory_allocation_calibrate(void)
+{
+    tm_calibrate(TM_MEMORY_ALLOCATION_ID, tm_memory_allocation_skeleton);
+}
+
+/* Define the memory allocation counter read function.  */
+static unsigned long long tm_memory_allocation_counter_read(void)
+{
+    return tm_counter_read(&tm_memory_allocation_counter);
+}
+
 /* Define the memory allocation test reporting function.  */
 void tm_memory_allocation_thread_report(void)
 {
 
-    unsigned long last_counter;
+    unsigned long period_counter;
     unsigned long relative_time;
 
-    /* Initialize the last counter.  */
-    last_counter = 0;
-
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_counter = tm_measure(TM_MEMORY_ALLOCATION_ID, tm_memory_allocation_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* See if there are any errors.  */
-        if (tm_memory_allocation_counter == last_counter) {
+        if (period_counter == 0) {
 
             printf("ERROR: Invalid counter value(s). Error allocating/deallocating "
                    "memory!\n");
@@ -140,11 +175,10 @@ void tm_memory_allocation_thread_report(void)
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Memory Allocation Test",
-               tm_memory_allocation_counter - last_counter, relative_time, rt_tick_get());
-        /* Save the last counter.  */
-        last_counter = tm_memory_allocation_counter;
+               period_counter, relative_time, rt_tick_get());
+        tm_measure_report(TM_MEMORY_ALLOCATION_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
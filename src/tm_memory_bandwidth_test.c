@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Memory bandwidth test. Runs the STREAM kernels (copy, scale, add, triad)
+ * over three arrays of TM_BANDWIDTH_ARRAY_BYTES each, then copies and fills
+ * an array with libc memcpy/memset, rt_memcpy/rt_memset and a hand
+ * vectorized copy. Each kernel runs in the test thread for one test period,
+ * optionally preempted by a higher priority thread, and its result is
+ * checked afterwards. The sustained bandwidth is reported in MB/s.
+ */
+
+#include "tm_api.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#define TM_BANDWIDTH_SIMD      "helium copy"
+#define TM_BANDWIDTH_SIMD_ARM  1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TM_BANDWIDTH_SIMD      "neon copy"
+#define TM_BANDWIDTH_SIMD_ARM  1
+#elif defined(__riscv_vector)
+#include <riscv_vector.h>
+#define TM_BANDWIDTH_SIMD      "rvv copy"
+#define TM_BANDWIDTH_SIMD_RVV  1
+#else
+#define TM_BANDWIDTH_SIMD      "unrolled copy"
+#endif
+
+/* Define the number of elements of each array and the STREAM scalar.  */
+#define TM_BANDWIDTH_WORDS  (TM_BANDWIDTH_ARRAY_BYTES / sizeof(unsigned long))
+#define TM_BANDWIDTH_SCALAR 3
+#define TM_BANDWIDTH_FILL   0x5A
+
+TM_COUNTER tm_memory_bandwidth_counter;
+TM_COUNTER tm_memory_bandwidth_preemptions;
+
+/* Define the arrays, a and b are the inputs of the copies and c their output.  */
+
+static unsigned long *tm_bandwidth_a;
+static unsigned long *tm_bandwidth_b;
+static unsigned long *tm_bandwidth_c;
+static int tm_bandwidth_allocated;
+
+/* Define a kernel of the test, moving the specified number of arrays per pass.  */
+
+typedef struct tm_bandwidth_kernel {
+    const char *name;
+    int arrays;
+    void (*run)(void);
+    int (*check)(void);
+} tm_bandwidth_kernel_t;
+
+/* Define the kernel run by the test thread.  */
+
+static const tm_bandwidth_kernel_t *volatile tm_bandwidth_current;
+
+/* Define the test thread prototypes.  */
+
+void tm_memory_bandwidth_thread_0_entry(void *p1, void *p2, void *p3);
+void tm_memory_bandwidth_thread_1_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_memory_bandwidth_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_memory_bandwidth_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_memory_bandwidth_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_memory_bandwidth_initialize);
+
+    return 0;
+}
+
+/* Define the STREAM kernels.  */
+
+static void tm_bandwidth_copy(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        tm_bandwidth_c[i] = tm_bandwidth_a[i];
+    }
+}
+
+static void tm_bandwidth_scale(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        tm_bandwidth_b[i] = TM_BANDWIDTH_SCALAR * tm_bandwidth_c[i];
+    }
+}
+
+static void tm_bandwidth_add(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        tm_bandwidth_c[i] = tm_bandwidth_a[i] + tm_bandwidth_b[i];
+    }
+}
+
+static void tm_bandwidth_triad(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        tm_bandwidth_a[i] = tm_bandwidth_b[i] + TM_BANDWIDTH_SCALAR * tm_bandwidth_c[i];
+    }
+}
+
+/* Define the library copies and fills.  */
+
+static void tm_bandwidth_memcpy(void)
+{
+    memcpy(tm_bandwidth_c, tm_bandwidth_a, TM_BANDWIDTH_ARRAY_BYTES);
+}
+
+static void tm_bandwidth_rt_memcpy(void)
+{
+    rt_memcpy(tm_bandwidth_c, tm_bandwidth_a, TM_BANDWIDTH_ARRAY_BYTES);
+}
+
+static void tm_bandwidth_memset(void)
+{
+    memset(tm_bandwidth_c, TM_BANDWIDTH_FILL, TM_BANDWIDTH_ARRAY_BYTES);
+}
+
+static void tm_bandwidth_rt_memset(void)
+{
+    rt_memset(tm_bandwidth_c, TM_BANDWIDTH_FILL, TM_BANDWIDTH_ARRAY_BYTES);
+}
+
+/* Define the hand vectorized copy, 64 bytes per iteration.  */
+static void tm_bandwidth_simd_copy(void)
+{
+    unsigned char *source = (unsigned char *)tm_bandwidth_a;
+    unsigned char *destination = (unsigned char *)tm_bandwidth_c;
+#if defined(TM_BANDWIDTH_SIMD_ARM)
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_ARRAY_BYTES; i += 64) {
+        uint8x16_t v0 = vld1q_u8(&source[i]);
+        uint8x16_t v1 = vld1q_u8(&source[i + 16]);
+        uint8x16_t v2 = vld1q_u8(&source[i + 32]);
+        uint8x16_t v3 = vld1q_u8(&source[i + 48]);
+
+        vst1q_u8(&destination[i], v0);
+        vst1q_u8(&destination[i + 16], v1);
+        vst1q_u8(&destination[i + 32], v2);
+        vst1q_u8(&destination[i + 48], v3);
+    }
+#elif defined(TM_BANDWIDTH_SIMD_RVV)
+    unsigned long i;
+    size_t vl;
+
+    for (i = 0; i < TM_BANDWIDTH_ARRAY_BYTES; i += vl) {
+        vl = __riscv_vsetvl_e8m8(TM_BANDWIDTH_ARRAY_BYTES - i);
+        __riscv_vse8_v_u8m8(&destination[i], __riscv_vle8_v_u8m8(&source[i], vl), vl);
+    }
+#else
+    unsigned long *s = (unsigned long *)source;
+    unsigned long *d = (unsigned long *)destination;
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i += 4) {
+        unsigned long w0 = s[i];
+        unsigned long w1 = s[i + 1];
+        unsigned long w2 = s[i + 2];
+        unsigned long w3 = s[i + 3];
+
+        d[i] = w0;
+        d[i + 1] = w1;
+        d[i + 2] = w2;
+        d[i + 3] = w3;
+    }
+#endif
+}
+
+/* Define the checks of the kernel results.  */
+
+static int tm_bandwidth_check_copy(void)
+{
+    return (memcmp(tm_bandwidth_c, tm_bandwidth_a, TM_BANDWIDTH_ARRAY_BYTES) == 0) ? TM_SUCCESS : TM_ERROR;
+}
+
+static int tm_bandwidth_check_scale(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        if (tm_bandwidth_b[i] != TM_BANDWIDTH_SCALAR * tm_bandwidth_c[i]) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+static int tm_bandwidth_check_add(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        if (tm_bandwidth_c[i] != tm_bandwidth_a[i] + tm_bandwidth_b[i]) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+static int tm_bandwidth_check_triad(void)
+{
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+        if (tm_bandwidth_a[i] != tm_bandwidth_b[i] + TM_BANDWIDTH_SCALAR * tm_bandwidth_c[i]) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+static int tm_bandwidth_check_fill(void)
+{
+    unsigned char *c = (unsigned char *)tm_bandwidth_c;
+    unsigned long i;
+
+    for (i = 0; i < TM_BANDWIDTH_ARRAY_BYTES; i++) {
+        if (c[i] != TM_BANDWIDTH_FILL) {
+            return TM_ERROR;
+        }
+    }
+
+    return TM_SUCCESS;
+}
+
+/* Define the kernels, in the order they are measured. Each leaves the inputs of the next valid.  */
+
+static const tm_bandwidth_kernel_t tm_bandwidth_kernel[] = {
+    {"stream copy",      2, tm_bandwidth_copy,      tm_bandwidth_check_copy},
+    {"stream scale",     2, tm_bandwidth_scale,     tm_bandwidth_check_scale},
+    {"stream add",       3, tm_bandwidth_add,       tm_bandwidth_check_add},
+    {"stream triad",     3, tm_bandwidth_triad,     tm_bandwidth_check_triad},
+    {"memcpy",           2, tm_bandwidth_memcpy,    tm_bandwidth_check_copy},
+    {"rt_memcpy",        2, tm_bandwidth_rt_memcpy, tm_bandwidth_check_copy},
+    {TM_BANDWIDTH_SIMD,  2, tm_bandwidth_simd_copy, tm_bandwidth_check_copy},
+    {"memset",           1, tm_bandwidth_memset,    tm_bandwidth_check_fill},
+    {"rt_memset",        1, tm_bandwidth_rt_memset, tm_bandwidth_check_fill},
+};
+
+#define TM_BANDWIDTH_KERNEL_NUM (sizeof(tm_bandwidth_kernel) / sizeof(tm_bandwidth_kernel[0]))
+
+/* Define the results of each kernel.  */
+
+static unsigned long tm_bandwidth_ops[TM_BANDWIDTH_KERNEL_NUM];
+static int tm_bandwidth_status[TM_BANDWIDTH_KERNEL_NUM];
+static unsigned long long tm_bandwidth_preemptions_start;
+
+/* Define the memory bandwidth test initialization.  */
+
+void tm_memory_bandwidth_initialize(void)
+{
+    unsigned long i;
+
+    /* Allocate and fill the arrays.  */
+    tm_bandwidth_a = (unsigned long *)rt_malloc_align(TM_BANDWIDTH_ARRAY_BYTES, TM_CACHE_LINE_SIZE);
+    tm_bandwidth_b = (unsigned long *)rt_malloc_align(TM_BANDWIDTH_ARRAY_BYTES, TM_CACHE_LINE_SIZE);
+    tm_bandwidth_c = (unsigned long *)rt_malloc_align(TM_BANDWIDTH_ARRAY_BYTES, TM_CACHE_LINE_SIZE);
+    tm_bandwidth_allocated = (tm_bandwidth_a != RT_NULL) && (tm_bandwidth_b != RT_NULL) && (tm_bandwidth_c != RT_NULL);
+    if (tm_bandwidth_allocated) {
+
+        for (i = 0; i < TM_BANDWIDTH_WORDS; i++) {
+            tm_bandwidth_a[i] = i;
+            tm_bandwidth_b[i] = 2 * i;
+            tm_bandwidth_c[i] = 0;
+        }
+
+        tm_bandwidth_preemptions_start = tm_counter_read(&tm_memory_bandwidth_preemptions);
+        for (i = 0; i < TM_BANDWIDTH_KERNEL_NUM; i++) {
+
+            /* Run the test thread on the kernel for one period.  */
+            tm_bandwidth_current = &tm_bandwidth_kernel[i];
+
+            /* Create thread 0 at priority 10.  */
+            tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_memory_bandwidth_thread_0_entry);
+
+#if TM_BANDWIDTH_PREEMPT_MS
+            /* Create thread 1 at a higher priority to preempt it periodically.  */
+            tm_thread_create(1, CONFIG_MAIN_THREAD_PRIORITY, tm_memory_bandwidth_thread_1_entry);
+            tm_thread_resume(1);
+#endif
+
+            /* Resume thread 0.  */
+            tm_thread_resume(0);
+
+            tm_memory_bandwidth_thread_report();
+        }
+    } else {
+
+        printf("ERROR: Unable to allocate the memory bandwidth arrays!\n");
+        tm_bandwidth_current = &tm_bandwidth_kernel[TM_BANDWIDTH_KERNEL_NUM - 1];
+        for (i = 0; i < TM_BANDWIDTH_KERNEL_NUM; i++) {
+            tm_bandwidth_ops[i] = 0;
+            tm_bandwidth_status[i] = TM_ERROR;
+        }
+        tm_memory_bandwidth_thread_report();
+    }
+
+    /* Make sure that no thread still uses the arrays before they are freed.  */
+    tm_thread_detach_wait();
+    if (tm_bandwidth_a != RT_NULL) {
+        rt_free_align(tm_bandwidth_a);
+    }
+    if (tm_bandwidth_b != RT_NULL) {
+        rt_free_align(tm_bandwidth_b);
+    }
+    if (tm_bandwidth_c != RT_NULL) {
+        rt_free_align(tm_bandwidth_c);
+    }
+}
+
+/* Define the memory bandwidth thread.  */
+void tm_memory_bandwidth_thread_0_entry(void *p1, void *p2, void *p3)
+{
+    const tm_bandwidth_kernel_t *kernel = tm_bandwidth_current;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Run one pass of the kernel.  */
+        kernel->run();
+
+        /* Increment the memory bandwidth counter.  */
+        tm_counter_increment(&tm_memory_bandwidth_counter);
+    }
+}
+
+/* Define the preempting thread.  */
+void tm_memory_bandwidth_thread_1_entry(void *p1, void *p2, void *p3)
+{
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Wake up periodically and preempt the memory bandwidth thread.  */
+        tm_thread_sleep_ms(TM_BANDWIDTH_PREEMPT_MS);
+
+        /* Increment the number of preemptions.  */
+        tm_counter_increment(&tm_memory_bandwidth_preemptions);
+    }
+}
+
+/* Define the memory bandwidth counter read function.  */
+static unsigned long long tm_memory_bandwidth_counter_read(void)
+{
+    return tm_counter_read(&tm_memory_bandwidth_counter);
+}
+
+/*
+ * Define the memory bandwidth reporting function. It measures the current
+ * kernel and prints the test once the last one has been measured.
+ */
+void tm_memory_bandwidth_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long long rate;
+    unsigned int index;
+    unsigned int i;
+    char buffer[16];
+    int failed;
+
+    index = (unsigned int)(tm_bandwidth_current - tm_bandwidth_kernel);
+
+    /* Measure the kernel for one period, then stop it and check its result.  */
+    if (tm_bandwidth_allocated) {
+        tm_bandwidth_ops[index] = tm_measure(TM_MEMORY_BANDWIDTH_ID, tm_memory_bandwidth_counter_read);
+        tm_thread_detach();
+        tm_bandwidth_status[index] = (tm_bandwidth_ops[index] != 0) ? tm_bandwidth_current->check() : TM_ERROR;
+    }
+
+    if (index + 1 < TM_BANDWIDTH_KERNEL_NUM) {
+        return;
+    }
+
+    /* Total the passes of all kernels.  */
+    period_counter = 0;
+    failed = 0;
+    for (i = 0; i < TM_BANDWIDTH_KERNEL_NUM; i++) {
+        period_counter += tm_bandwidth_ops[i];
+        failed |= (tm_bandwidth_status[i] != TM_SUCCESS);
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Memory bandwidth thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_MEMORY_BANDWIDTH_ID, "kernel result is wrong");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Memory Bandwidth Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)TM_BANDWIDTH_KERNEL_NUM, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  kernel", "bytes/pass", "passes", "MB/s");
+    for (i = 0; i < TM_BANDWIDTH_KERNEL_NUM; i++) {
+
+        /* Compute the MB/s, x100.  */
+        rate = (unsigned long long)tm_bandwidth_ops[i] * tm_bandwidth_kernel[i].arrays * TM_BANDWIDTH_ARRAY_BYTES /
+               (TM_TEST_DURATION_VALUE * 10000ULL);
+
+        printf("|   %-38s | %-10lu | %-10lu | %-10s |\n", tm_bandwidth_kernel[i].name,
+               (unsigned long)(tm_bandwidth_kernel[i].arrays * TM_BANDWIDTH_ARRAY_BYTES), tm_bandwidth_ops[i],
+               (tm_bandwidth_status[i] == TM_SUCCESS) ? tm_measure_format(buffer, sizeof(buffer), rate) : "FAILED");
+    }
+#if TM_BANDWIDTH_PREEMPT_MS
+    printf("| %-40s | %-10lu | %-10lu | %-10s |\n", "  preemptions, every ms",
+           (unsigned long)(tm_counter_read(&tm_memory_bandwidth_preemptions) - tm_bandwidth_preemptions_start),
+           (unsigned long)TM_BANDWIDTH_PREEMPT_MS, "");
+#endif
+    tm_measure_report(TM_MEMORY_BANDWIDTH_ID);
+
+    tm_teardown();
+}
@@ -43,7 +43,7 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_message_processing_counter;
+TM_COUNTER tm_message_processing_counter;
 unsigned int tm_message_sent[4];
 unsigned int tm_message_received[4];
 
@@ -86,6 +86,39 @@ void tm_message_processing_initialize(void)
     tm_message_processing_thread_report();
 }
 
+#if TM_MESSAGE_VALIDATE
+/* Define the checksum over the first three words of a message.  */
+static unsigned int tm_message_checksum(const unsigned int *message)
+{
+    unsigned int sum = 0x77778888;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        sum = ((sum << 5) | (sum >> 27)) ^ message[i];
+    }
+
+    return sum;
+}
+
+/* Fill a message with the sequence number, a payload derived from it and the checksum.  */
+static void tm_message_fill(unsigned int *message, unsigned int sequence)
+{
+    message[0] = sequence;
+    message[1] = sequence * 0x9E3779B9;
+    message[2] = ~sequence ^ 0x55556666;
+    message[3] = tm_message_checksum(message);
+}
+
+/* Check that a message is complete and carries the expected sequence number.  */
+static int tm_message_valid(const unsigned int *message, unsigned int sequence)
+{
+    return (message[0] == sequence) &&
+           (message[1] == sequence * 0x9E3779B9) &&
+           (message[2] == (~sequence ^ 0x55556666)) &&
+           (message[3] == tm_message_checksum(message));
+}
+#endif
+
 /* Define the message processing thread.  */
 void tm_message_processing_thread_0_entry(void *p1, void *p2, void *p3)
 {
@@ -93,6 +126,32 @@ void tm_message_processing_thread_0_entry(void *p1, void *p2, void *p3)
     (void)p2;
     (void)p3;
 
+#if TM_MESSAGE_VALIDATE
+    unsigned int sequence = 0;
+
+    while (1) {
+        /* Send the next message of the sequence to the queue.  */
+        tm_message_fill(tm_message_sent, sequence);
+        tm_queue_send(0, (unsigned long *)tm_message_sent);
+
+        /* Receive a message from the queue, clearing the buffer first so stale data cannot pass.  */
+        tm_message_received[0] = ~sequence;
+        tm_queue_receive(0, (unsigned long *)tm_message_received);
+
+        /* Check the whole message, then stop here so the test can be torn down.  */
+        if (!tm_message_valid(tm_message_received, sequence)) {
+            tm_measure_fail(TM_MESSAGE_PROCESSING_ID, "message lost, reordered or corrupted");
+            while (1) {
+                tm_thread_suspend(0);
+            }
+        }
+
+        sequence++;
+
+        /* Increment the number of messages sent and received.  */
+        tm_counter_increment(&tm_message_processing_counter);
+    }
+#else
     /* Initialize the source message.   */
     tm_message_sent[0] = 0x11112222;
     tm_message_sent[1] = 0x33334444;
@@ -115,33 +174,96 @@ void tm_message_processing_thread_0_entry(void *p1, void *p2, void *p3)
         tm_message_sent[3]++;
 
         /* Increment the number of messages sent and received.  */
-        tm_message_processing_counter++;
+        tm_counter_increment(&tm_message_processing_counter);
+    }
+#endif
+}
+
+/* Define the loop skeleton of the message processing thread, with the RTOS services stubbed out.  */
+static TM_COUNTER tm_message_skeleton_counter;
+static unsigned int tm_message_skeleton_sent[4];
+static unsigned int tm_message_skeleton_received[4];
+
+static void tm_message_processing_skeleton(unsigned long iterations)
+{
+#if TM_MESSAGE_VALIDATE
+    unsigned int sequence = 0;
+
+    while (iterations--) {
+
+        /* Send the next message of the sequence to the queue.  */
+        tm_message_fill(tm_message_skeleton_sent, sequence);
+        tm_calibration_stub(0, tm_message_skeleton_sent);
+
+        /* Receive a message from the queue.  */
+        tm_message_skeleton_received[0] = ~sequence;
+        tm_calibration_stub(0, tm_message_skeleton_received);
+
+        /* Check the whole message.  */
+        if (!tm_message_valid(tm_message_skeleton_received, sequence)) {
+            tm_message_skeleton_received[0] = sequence;
+        }
+
+        sequence++;
+
+        /* Increment the number of messages sent and received.  */
+        tm_counter_increment(&tm_message_skeleton_counter);
+    }
+#else
+    while (iterations--) {
+
+        /* Send a message to the queue.  */
+        tm_calibration_stub(0, tm_message_skeleton_sent);
+
+        /* Receive a message from the queue.  */
+        tm_calibration_stub(0, tm_message_skeleton_received);
+
+        /* Check for invalid message.  */
+        if (tm_message_skeleton_received[3] != tm_message_skeleton_sent[3]) {
+            tm_message_skeleton_received[3] = tm_message_skeleton_sent[3];
+        }
+
+        /* Increment the last word of the 16-byte message.  */
+        tm_message_skeleton_sent[3]++;
+
+        /* Increment the number of messages sent and received.  */
+        tm_counter_increment(&tm_message_skeleton_counter);
     }
+#endif
+}
+
+/* Define the message processing test calibration function.  */
+void tm_message_processing_calibrate(void)
+{
+    tm_calibrate(TM_MESSAGE_PROCESSING_ID, tm_message_processing_skeleton);
+}
+
+/* Define the message processing counter read function.  */
+static unsigned long long tm_message_processing_counter_read(void)
+{
+    return tm_counter_read(&tm_message_processing_counter);
 }
 
 /* Define the message test reporting function.  */
 void tm_message_processing_thread_report(void)
 {
 
-    unsigned long last_counter;
+    unsigned long period_counter;
     unsigned long relative_time;
 
-    /* Initialize the last counter.  */
-    last_counter = 0;
-
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_counter = tm_measure(TM_MESSAGE_PROCESSING_ID, tm_message_processing_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* See if there are any errors.  */
-        if (tm_message_processing_counter == last_counter) {
+        if (period_counter == 0) {
 
             printf("ERROR: Invalid counter value(s). Error sending/receiving "
                    "messages!\n");
@@ -151,11 +273,10 @@ void tm_message_processing_thread_report(void)
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Message Processing Test",
-               tm_message_processing_counter - last_counter, relative_time, rt_tick_get());
-        /* Save the last counter.  */
-        last_counter = tm_message_processing_counter;
+               period_counter, relative_time, rt_tick_get());
+        tm_measure_report(TM_MESSAGE_PROCESSING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
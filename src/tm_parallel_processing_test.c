@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Parallel processing test. Runs the basic processing kernel in one thread
+ * per core, each bound to its core: first on one core, then on all cores
+ * with a private array each, then on all cores with one shared array. Each
+ * variant runs for one test period and the checksum of every thread is
+ * verified as in the basic processing test.
+ */
+
+#include "tm_api.h"
+
+#define TM_PARALLEL_WORDS   1024
+#define TM_PARALLEL_VARIANT 3
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_PARALLEL_MAX_THREADS 8
+
+TM_COUNTER tm_parallel_processing_counter[TM_PARALLEL_MAX_THREADS];
+
+/* Define the checksum of the last passes of each thread, indexed by the pass number modulo 2.  */
+static tm_basic_processing_result_t tm_parallel_processing_result[TM_PARALLEL_MAX_THREADS][2];
+
+/* Define the working set of each thread.  */
+static unsigned long *tm_parallel_processing_data[TM_PARALLEL_MAX_THREADS];
+
+/* Define the number of threads of the variant being measured.  */
+static int tm_parallel_processing_threads;
+
+/* Define the name of each variant.  */
+static const char *tm_parallel_variant_name[TM_PARALLEL_VARIANT] = {
+    "  1 core, private array",
+    "  all cores, private arrays",
+    "  all cores, shared array",
+};
+
+/* Define the results of each variant.  */
+static int tm_parallel_variant_threads[TM_PARALLEL_VARIANT];
+static unsigned long tm_parallel_variant_ops[TM_PARALLEL_VARIANT];
+static unsigned long tm_parallel_variant_core_ops[TM_PARALLEL_VARIANT][TM_PARALLEL_MAX_THREADS];
+static int tm_parallel_variant_status[TM_PARALLEL_VARIANT];
+
+/* Define the test thread prototypes.  */
+
+void tm_parallel_processing_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_parallel_processing_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_parallel_processing_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_parallel_processing_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_parallel_processing_initialize);
+
+    return 0;
+}
+
+/* Define the parallel processing thread, one per core.  */
+void tm_parallel_processing_thread_entry(void *p1, void *p2, void *p3)
+{
+    tm_basic_processing_result_t *result;
+    unsigned long checksum;
+    unsigned long pass;
+    int id = (int)(long)p1;
+
+    (void)p2;
+    (void)p3;
+
+    /* Number the passes after those counted by earlier threads of the test.  */
+    pass = (unsigned long)tm_counter_read(&tm_parallel_processing_counter[id]);
+    while (1) {
+
+        /* Run one pass of the kernel over the array of the thread.  */
+        checksum = tm_basic_processing_kernel(TM_BASIC_KERNEL, tm_parallel_processing_data[id],
+                                              TM_PARALLEL_WORDS, pass);
+
+        /* Publish the checksum before the pass is counted.  */
+        result = &tm_parallel_processing_result[id][pass & 1];
+        result->pass = pass;
+        result->checksum = checksum;
+        pass++;
+
+        /* Increment the counter of the thread.  */
+        tm_counter_increment(&tm_parallel_processing_counter[id]);
+    }
+}
+
+/* Define the parallel processing counter read function, the total of all threads.  */
+static unsigned long long tm_parallel_processing_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_parallel_processing_threads; i++) {
+        total += tm_counter_read(&tm_parallel_processing_counter[i]);
+    }
+
+    return total;
+}
+
+/* Measure one variant of the test.  */
+static void tm_parallel_processing_variant(int variant, int threads, int shared)
+{
+    unsigned long long start[TM_PARALLEL_MAX_THREADS];
+    unsigned long long delta[TM_PARALLEL_MAX_THREADS];
+    unsigned long long total;
+    unsigned long *arrays;
+    unsigned long checksum;
+    int i;
+
+    tm_parallel_variant_threads[variant] = threads;
+    tm_parallel_variant_status[variant] = TM_ERROR;
+
+    /* Allocate and fill the private arrays, or one array shared by all threads.  */
+    arrays = (unsigned long *)rt_malloc_align((shared ? 1 : threads) * TM_PARALLEL_WORDS * sizeof(unsigned long),
+                                              TM_CACHE_LINE_SIZE);
+    if (arrays == RT_NULL) {
+        return;
+    }
+    for (i = 0; i < threads; i++) {
+        tm_parallel_processing_data[i] = shared ? arrays : &arrays[i * TM_PARALLEL_WORDS];
+        if ((i == 0) || !shared) {
+            tm_basic_processing_fill(tm_parallel_processing_data[i], TM_PARALLEL_WORDS);
+        }
+    }
+
+    /* Create one thread per core at priority 10 and bind it to its core.  */
+    tm_parallel_processing_threads = threads;
+    for (i = 0; i < threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_parallel_processing_thread_entry);
+        tm_thread_bind(i, i);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_resume(i);
+        start[i] = tm_counter_read(&tm_parallel_processing_counter[i]);
+    }
+
+    /* Measure the total for one period.  */
+    tm_parallel_variant_ops[variant] = tm_measure(TM_PARALLEL_PROCESSING_ID, tm_parallel_processing_counter_read);
+
+    /* Split the total between the cores by their share of the passes.  */
+    total = 0;
+    for (i = 0; i < threads; i++) {
+        delta[i] = tm_counter_read(&tm_parallel_processing_counter[i]) - start[i];
+        total += delta[i];
+    }
+    for (i = 0; i < threads; i++) {
+        tm_parallel_variant_core_ops[variant][i] =
+            (total != 0) ? (unsigned long)(tm_parallel_variant_ops[variant] * delta[i] / total) : 0;
+    }
+
+    /* Stop the threads, then check the checksum of each.  */
+    tm_thread_detach_wait();
+    tm_parallel_variant_status[variant] = TM_SUCCESS;
+    for (i = 0; i < threads; i++) {
+        if (tm_basic_processing_verify(&tm_parallel_processing_counter[i], tm_parallel_processing_result[i],
+                                       tm_parallel_processing_data[i], TM_PARALLEL_WORDS, &checksum) != TM_SUCCESS) {
+            tm_parallel_variant_status[variant] = TM_ERROR;
+        }
+    }
+    rt_free_align(arrays);
+}
+
+/* Define the parallel processing test initialization.  */
+
+void tm_parallel_processing_initialize(void)
+{
+    int cores = tm_cpu_count();
+
+    if (cores > TM_PARALLEL_MAX_THREADS) {
+        cores = TM_PARALLEL_MAX_THREADS;
+    }
+
+    tm_parallel_processing_variant(0, 1, 0);
+    tm_parallel_processing_variant(1, cores, 0);
+    tm_parallel_processing_variant(2, cores, 1);
+
+    tm_parallel_processing_thread_report();
+}
+
+/* Define the parallel processing reporting function.  */
+void tm_parallel_processing_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long base;
+    char label[48];
+    char buffer[16];
+    int failed;
+    int v;
+    int i;
+
+    /* The test total is the aggregate throughput over private arrays.  */
+    period_counter = tm_parallel_variant_ops[1];
+    failed = 0;
+    for (v = 0; v < TM_PARALLEL_VARIANT; v++) {
+        failed |= (tm_parallel_variant_status[v] != TM_SUCCESS);
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Parallel processing thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_PARALLEL_PROCESSING_ID, "kernel checksum mismatch");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Parallel Processing Test", period_counter,
+           TM_TEST_DURATION_VALUE * TM_PARALLEL_VARIANT, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  variant, per core", "cores", "period", "speedup");
+    base = tm_parallel_variant_ops[0];
+    for (v = 0; v < TM_PARALLEL_VARIANT; v++) {
+        printf("| %-40s | %-10d | %-10lu | %-10s |\n", tm_parallel_variant_name[v], tm_parallel_variant_threads[v],
+               tm_parallel_variant_ops[v],
+               (tm_parallel_variant_status[v] != TM_SUCCESS) ? "FAILED" : ((base == 0) ? "-" :
+               tm_measure_format(buffer, sizeof(buffer), (unsigned long long)tm_parallel_variant_ops[v] * 100 / base)));
+
+        /* Show the share of each core, with its speedup over the single core variant.  */
+        for (i = 0; (v != 0) && (i < tm_parallel_variant_threads[v]); i++) {
+            snprintf(label, sizeof(label), "    cpu %d", i);
+            printf("| %-40s | %-10s | %-10lu | %-10s |\n", label, "",
+                   tm_parallel_variant_core_ops[v][i], (base == 0) ? "-" :
+                   tm_measure_format(buffer, sizeof(buffer), (unsigned long long)tm_parallel_variant_core_ops[v][i] * 100 / base));
+        }
+    }
+    tm_measure_report(TM_PARALLEL_PROCESSING_ID);
+
+    tm_teardown();
+}
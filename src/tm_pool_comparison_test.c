@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Pool comparison test. Runs the loop of the memory allocation test, one
+ * allocation and one free per pass, in 1 to N threads, each bound to its own
+ * core, against an rt_mempool and against the lock-free and the per-core
+ * pools of tm_reference.h. Each pool and number of threads runs for one test
+ * period. Every thread marks the blocks it holds and checks the mark before
+ * it frees them, so that a block handed out twice fails the test.
+ */
+
+#include "tm_api.h"
+#include "tm_reference.h"
+
+/* Define the pools compared.  */
+#define TM_POOL_COMPARISON_MEMPOOL 0
+#define TM_POOL_COMPARISON_LOCKFREE 1
+#define TM_POOL_COMPARISON_PERCPU  2
+#define TM_POOL_COMPARISON_KINDS   3
+
+/* Define the blocks of each pool, as in the memory allocation test.  */
+#define TM_POOL_COMPARISON_BLOCK_SIZE 128
+#define TM_POOL_COMPARISON_BLOCKS     64
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_POOL_COMPARISON_MAX_THREADS 8
+
+static const char *tm_pool_comparison_kind_name[TM_POOL_COMPARISON_KINDS] = {
+    "rt_mempool",
+    "lock-free",
+    "per-core",
+};
+
+TM_COUNTER tm_pool_comparison_counter[TM_POOL_COMPARISON_MAX_THREADS];
+
+/* Define the pools, only the one of the current variant is initialized.  */
+
+static struct rt_mempool tm_pool_comparison_mempool;
+static tm_lockfree_pool_t tm_pool_comparison_lockfree;
+static tm_percpu_pool_t tm_pool_comparison_percpu;
+
+/* Define the pool and the number of threads of the current variant.  */
+
+static volatile int tm_pool_comparison_kind;
+static int tm_pool_comparison_threads;
+
+/* Set if a thread found the mark of its block changed.  */
+static volatile int tm_pool_comparison_corrupted;
+
+/* Define the results of each variant.  */
+static unsigned long tm_pool_comparison_ops[TM_POOL_COMPARISON_KINDS][TM_POOL_COMPARISON_MAX_THREADS];
+static int tm_pool_comparison_status[TM_POOL_COMPARISON_KINDS][TM_POOL_COMPARISON_MAX_THREADS];
+static const char *tm_pool_comparison_reason[TM_POOL_COMPARISON_KINDS][TM_POOL_COMPARISON_MAX_THREADS];
+static int tm_pool_comparison_cores;
+
+/* Define the test thread prototypes.  */
+
+void tm_pool_comparison_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_pool_comparison_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_pool_comparison_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_pool_comparison_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_pool_comparison_initialize);
+
+    return 0;
+}
+
+/*
+ * Allocate a block from the pool of the current variant without waiting.
+ * Returns the block, RT_NULL if the pool is empty.
+ */
+static unsigned long *tm_pool_comparison_alloc(int kind)
+{
+    if (kind == TM_POOL_COMPARISON_MEMPOOL) {
+        return (unsigned long *)rt_mp_alloc(&tm_pool_comparison_mempool, RT_WAITING_NO);
+    }
+    if (kind == TM_POOL_COMPARISON_LOCKFREE) {
+        return (unsigned long *)tm_lockfree_pool_alloc(&tm_pool_comparison_lockfree);
+    }
+    return (unsigned long *)tm_percpu_pool_alloc(&tm_pool_comparison_percpu);
+}
+
+/* Free a block to the pool of the current variant.  */
+static void tm_pool_comparison_free(int kind, unsigned long *block)
+{
+    if (kind == TM_POOL_COMPARISON_MEMPOOL) {
+        rt_mp_free(block);
+    } else if (kind == TM_POOL_COMPARISON_LOCKFREE) {
+        tm_lockfree_pool_free(&tm_pool_comparison_lockfree, block);
+    } else {
+        tm_percpu_pool_free(&tm_pool_comparison_percpu, block);
+    }
+}
+
+/* Define the pool comparison thread, one per core.  */
+void tm_pool_comparison_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    int kind = tm_pool_comparison_kind;
+    unsigned long mark = (unsigned long)id << 24;
+    unsigned long *block;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Allocate a block, or let the other threads run if the pool is empty.  */
+        block = tm_pool_comparison_alloc(kind);
+        if (block == RT_NULL) {
+            tm_thread_relinquish();
+            continue;
+        }
+
+        /* Mark the first and the last word of the block.  */
+        block[0] = mark;
+        block[TM_POOL_COMPARISON_BLOCK_SIZE / sizeof(unsigned long) - 1] = mark;
+
+        /* Increment the counter of the thread.  */
+        tm_counter_increment(&tm_pool_comparison_counter[id]);
+
+        /* Check the mark and free the block.  */
+        if ((block[0] != mark) || (block[TM_POOL_COMPARISON_BLOCK_SIZE / sizeof(unsigned long) - 1] != mark)) {
+            tm_pool_comparison_corrupted = 1;
+        }
+        tm_pool_comparison_free(kind, block);
+        mark++;
+    }
+}
+
+/* Define the pool comparison counter read function, the total of all threads.  */
+static unsigned long long tm_pool_comparison_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_pool_comparison_threads; i++) {
+        total += tm_counter_read(&tm_pool_comparison_counter[i]);
+    }
+
+    return total;
+}
+
+/* Measure one pool with the specified number of threads.  */
+static void tm_pool_comparison_variant(int kind, int threads)
+{
+    unsigned long storage_size = TM_POOL_STORAGE_SIZE(TM_POOL_COMPARISON_BLOCKS, TM_POOL_COMPARISON_BLOCK_SIZE);
+    void *storage;
+    int i;
+
+    tm_pool_comparison_status[kind][threads - 1] = TM_ERROR;
+    tm_pool_comparison_reason[kind][threads - 1] = "out of memory";
+
+    /* Allocate the storage of the pool and initialize it.  */
+    storage = rt_malloc_align(storage_size, TM_CACHE_LINE_SIZE);
+    if (storage == RT_NULL) {
+        return;
+    }
+    if (kind == TM_POOL_COMPARISON_MEMPOOL) {
+        if (rt_mp_init(&tm_pool_comparison_mempool, "tm_cmp", storage, storage_size,
+                       TM_POOL_COMPARISON_BLOCK_SIZE) != RT_EOK) {
+            tm_pool_comparison_reason[kind][threads - 1] = "rt_mp_init failed";
+            rt_free_align(storage);
+            return;
+        }
+    } else if (kind == TM_POOL_COMPARISON_LOCKFREE) {
+        tm_lockfree_pool_init(&tm_pool_comparison_lockfree, storage, storage_size, TM_POOL_COMPARISON_BLOCK_SIZE);
+    } else {
+        tm_percpu_pool_init(&tm_pool_comparison_percpu, storage, storage_size, TM_POOL_COMPARISON_BLOCK_SIZE);
+    }
+
+    /* Create one thread per core at priority 10 and bind it to its core.  */
+    tm_pool_comparison_kind = kind;
+    tm_pool_comparison_threads = threads;
+    tm_pool_comparison_corrupted = 0;
+    for (i = 0; i < threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_pool_comparison_thread_entry);
+        tm_thread_bind(i, i);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_resume(i);
+    }
+
+    /* Measure the total for one period, then stop the threads.  */
+    tm_pool_comparison_ops[kind][threads - 1] = tm_measure(TM_POOL_COMPARISON_ID, tm_pool_comparison_counter_read);
+    tm_thread_detach_wait();
+    if (tm_pool_comparison_corrupted) {
+        tm_pool_comparison_reason[kind][threads - 1] = "block handed out twice";
+    } else if (tm_pool_comparison_ops[kind][threads - 1] == 0) {
+        tm_pool_comparison_reason[kind][threads - 1] = "a variant made no progress";
+    } else {
+        tm_pool_comparison_reason[kind][threads - 1] = RT_NULL;
+        tm_pool_comparison_status[kind][threads - 1] = TM_SUCCESS;
+    }
+    if (kind == TM_POOL_COMPARISON_MEMPOOL) {
+        rt_mp_detach(&tm_pool_comparison_mempool);
+    }
+    rt_free_align(storage);
+}
+
+/* Define the pool comparison test initialization.  */
+
+void tm_pool_comparison_initialize(void)
+{
+    int threads;
+    int kind;
+
+    tm_pool_comparison_cores = tm_cpu_count();
+    if (tm_pool_comparison_cores > TM_POOL_COMPARISON_MAX_THREADS) {
+        tm_pool_comparison_cores = TM_POOL_COMPARISON_MAX_THREADS;
+    }
+
+    for (threads = 1; threads <= tm_pool_comparison_cores; threads++) {
+        for (kind = 0; kind < TM_POOL_COMPARISON_KINDS; kind++) {
+            tm_pool_comparison_variant(kind, threads);
+        }
+    }
+
+    tm_pool_comparison_thread_report();
+}
+
+/* Define the pool comparison reporting function.  */
+void tm_pool_comparison_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long ops;
+    unsigned long base;
+    const char *reason;
+    char label[48];
+    char buffer[16];
+    int threads;
+    int kind;
+
+    /* Total the operations of all variants.  */
+    period_counter = 0;
+    reason = RT_NULL;
+    for (threads = 1; threads <= tm_pool_comparison_cores; threads++) {
+        for (kind = 0; kind < TM_POOL_COMPARISON_KINDS; kind++) {
+            period_counter += tm_pool_comparison_ops[kind][threads - 1];
+            if ((reason == RT_NULL) && (tm_pool_comparison_status[kind][threads - 1] != TM_SUCCESS)) {
+                reason = tm_pool_comparison_reason[kind][threads - 1];
+            }
+        }
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Pool comparison thread died!\n");
+    }
+    if (reason != RT_NULL) {
+
+        /* Report why the first failed variant failed.  */
+        tm_measure_fail(TM_POOL_COMPARISON_ID, reason);
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Pool Comparison Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)(TM_POOL_COMPARISON_KINDS * tm_pool_comparison_cores), rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  cores, pool", "period", "per core", "vs mempool");
+    for (threads = 1; threads <= tm_pool_comparison_cores; threads++) {
+        for (kind = 0; kind < TM_POOL_COMPARISON_KINDS; kind++) {
+            ops = tm_pool_comparison_ops[kind][threads - 1];
+            base = tm_pool_comparison_ops[TM_POOL_COMPARISON_MEMPOOL][threads - 1];
+            snprintf(label, sizeof(label), "%d, %s", threads, tm_pool_comparison_kind_name[kind]);
+            printf("|   %-38s | %-10lu | %-10lu | %-10s |\n", label, ops, ops / (unsigned long)threads,
+                   (tm_pool_comparison_status[kind][threads - 1] != TM_SUCCESS) ? "FAILED" : ((base == 0) ? "-" :
+                   tm_measure_format(buffer, sizeof(buffer), (unsigned long long)ops * 100 / base)));
+        }
+    }
+    tm_measure_report(TM_POOL_COMPARISON_ID);
+
+    tm_teardown();
+}
@@ -18,4 +18,97 @@ extern void tm_cause_interrupt(void);
 
 #define TM_CAUSE_INTERRUPT tm_cause_interrupt()
 
+/* Define the cache line size used to keep the test counters apart.  */
+#ifndef TM_CACHE_LINE_SIZE
+#ifdef RT_CPU_CACHE_LINE_SZ
+#define TM_CACHE_LINE_SIZE RT_CPU_CACHE_LINE_SZ
+#else
+#define TM_CACHE_LINE_SIZE 64
+#endif
+#endif
+
+/* Define the alignment of the test counters, a cache line each unless TM_COUNTER_PADDED is 0.  */
+#if TM_COUNTER_PADDED
+#define TM_COUNTER_ALIGN rt_align(TM_CACHE_LINE_SIZE)
+#else
+#define TM_COUNTER_ALIGN
+#endif
+
+/*
+ * Define the test counter. Each counter is incremented by a single thread or
+ * interrupt handler and read by the reporter, possibly on another core. It
+ * occupies its own cache line, unless TM_COUNTER_PADDED is 0, and counts to
+ * 64 bits on all targets; on 32-bit targets the high word is kept twice so
+ * that tm_counter_read() can detect a carry in progress and retry.
+ */
+typedef struct tm_counter
+{
+    TM_COUNTER_ALIGN volatile unsigned long low;
+#ifndef ARCH_CPU_64BIT
+    volatile unsigned long high;
+    volatile unsigned long high_check;
+#endif
+} TM_COUNTER;
+
+/* Stores of the counting thread are ordered before reads of the reporter on other cores.  */
+#ifdef RT_USING_SMP
+#define TM_COUNTER_ORDER __ATOMIC_RELEASE
+#else
+#define TM_COUNTER_ORDER __ATOMIC_RELAXED
+#endif
+
+/* Increment a counter. Must only be called by the counter's owner.  */
+rt_inline void tm_counter_increment(TM_COUNTER *counter)
+{
+    unsigned long low = counter->low + 1;
+
+#ifndef ARCH_CPU_64BIT
+    if (low == 0)
+    {
+        /* Publish the carry as high, low, high_check; the reader reads them in reverse.  */
+        __atomic_store_n(&counter->high, counter->high + 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&counter->low, low, __ATOMIC_RELEASE);
+        __atomic_store_n(&counter->high_check, counter->high, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+
+    __atomic_store_n(&counter->low, low, TM_COUNTER_ORDER);
+}
+
+/* Read a counter from any thread without tearing.  */
+rt_inline unsigned long long tm_counter_read(TM_COUNTER *counter)
+{
+#ifdef ARCH_CPU_64BIT
+    return __atomic_load_n(&counter->low, __ATOMIC_ACQUIRE);
+#else
+    unsigned long high;
+    unsigned long low;
+
+    do
+    {
+        high = __atomic_load_n(&counter->high_check, __ATOMIC_ACQUIRE);
+        low = __atomic_load_n(&counter->low, __ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&counter->high, __ATOMIC_ACQUIRE) != high);
+
+    return ((unsigned long long)high << 32) | low;
+#endif
+}
+
+/* Clear a counter. Must only be called while no thread or handler increments it.  */
+rt_inline void tm_counter_reset(TM_COUNTER *counter)
+{
+#ifndef ARCH_CPU_64BIT
+    counter->high = 0;
+    counter->high_check = 0;
+#endif
+    __atomic_store_n(&counter->low, 0, __ATOMIC_RELEASE);
+}
+
+/* Return the low word of a counter as seen by its owner.  */
+rt_inline unsigned long tm_counter_local(TM_COUNTER *counter)
+{
+    return counter->low;
+}
+
 #endif
@@ -22,32 +22,52 @@
 /* Include necessary files.  */
 #include "tm_api.h"
 #include <stdlib.h>
+#include <string.h>
 #include <rtthread.h>
 
-/* Define constants for the test suite */
-#define TM_TEST_NUM_THREADS        10
-#define TM_TEST_STACK_SIZE         1024
-#define TM_TEST_NUM_SEMAPHORES     4
-#define TM_TEST_NUM_MESSAGE_QUEUES 4
-#define TM_TEST_NUM_SLABS          4
+/* Provide the measured path services out-of-line unless they are inlined by tm_api.h */
+#if !TM_PORTING_LAYER_INLINE
+#define TM_PORT_API
+#include "tm_porting_layer_rtthread.h"
+#endif
 
 /* extern function */
 extern void tm_interrupt_preemption_handler(void);
 extern void tm_interrupt_handler(void);
 
-/* Define thread control blocks and stacks */
-static rt_thread_t test_thread[TM_TEST_NUM_THREADS];
+/* Define thread control blocks and stacks, for each slot */
+rt_thread_t tm_test_thread[TM_TEST_NUM_SLOTS * TM_TEST_NUM_THREADS];
 
 /* Define semaphores */
-static rt_sem_t test_sem[TM_TEST_NUM_SEMAPHORES];
+rt_sem_t tm_test_sem[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SEMAPHORES];
 
 /* Define message queues and buffers */
-static struct rt_messagequeue test_msgq[TM_TEST_NUM_MESSAGE_QUEUES];
-static char test_msgq_buffer[TM_TEST_NUM_MESSAGE_QUEUES][8][16];
+struct rt_messagequeue tm_test_msgq[TM_TEST_NUM_SLOTS * TM_TEST_NUM_MESSAGE_QUEUES];
+static char test_msgq_buffer[TM_TEST_NUM_SLOTS * TM_TEST_NUM_MESSAGE_QUEUES][8][16];
+static rt_uint8_t test_msgq_created[TM_TEST_NUM_SLOTS * TM_TEST_NUM_MESSAGE_QUEUES];
 
 /* Define memory pools and buffers */
-static struct rt_mempool test_slab[TM_TEST_NUM_SLABS];
-static char test_slab_buffer[TM_TEST_NUM_SLABS][8 * 128];
+struct rt_mempool tm_test_slab[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SLABS];
+static char test_slab_buffer[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SLABS][8 * 128];
+static rt_uint8_t test_slab_created[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SLABS];
+
+#if TM_CONCURRENT_ENABLE
+/* Define the number of slots in use, 0 unless "thread_metric concurrent" runs */
+static int tm_concurrent_tests;
+
+/* Define the core, -1 for any, and the priority offset of the threads of each slot */
+static int tm_slot_cpu[TM_TEST_NUM_SLOTS];
+static int tm_slot_priority[TM_TEST_NUM_SLOTS];
+
+/* Set while the tests of several slots run at once */
+static volatile int tm_concurrent_active;
+#endif
+
+/* Time given to the idle thread to reclaim deleted threads before the heap is checked */
+#define TM_TEARDOWN_SETTLE_MS      10
+
+/* Number of tests whose heap usage did not return to its pre-test value */
+static unsigned long tm_teardown_leaks;
 
 /*
  * This function performs basic RTOS initialization,
@@ -55,131 +75,322 @@ static char test_slab_buffer[TM_TEST_NUM_SLABS][8 * 128];
  */
 void tm_initialize(void (*test_initialization_function)(void))
 {
+#ifdef RT_USING_HEAP
+    rt_size_t total, used_before, used_after, max_used;
+
+    rt_memory_info(&total, &used_before, &max_used);
+#endif
+
     test_initialization_function();
+
+#ifdef RT_USING_HEAP
+    /* The test has torn down its objects, check that the heap is back where it was.  */
+    rt_thread_mdelay(TM_TEARDOWN_SETTLE_MS);
+    rt_memory_info(&total, &used_after, &max_used);
+    if ((used_after != used_before) && !tm_concurrent_running())
+    {
+        tm_teardown_leaks++;
+        printf("ERROR: Heap usage changed by %ld bytes across the test!\n",
+               (long)(used_after - used_before));
+    }
+#endif
 }
 
 /*
  * This function creates a thread with the specified ID and priority.
- * Priorities range from 1 (highest) to 31 (lowest).
+ * Priorities range from 1 (highest) to 31 (lowest). The thread ID is passed
+ * as the first argument of the entry function.
  * Returns TM_SUCCESS on success, TM_ERROR on failure.
  */
 int tm_thread_create(int thread_id, int priority, void (*entry_function)(void *, void *, void *))
 {
-    test_thread[thread_id] = rt_thread_create("metric",
+    int index = TM_TEST_INDEX(thread_id, TM_TEST_NUM_THREADS);
+
+#if TM_CONCURRENT_ENABLE
+    /* Move the thread by the priority offset of its slot, above the idle thread.  */
+    if (tm_concurrent_tests != 0)
+    {
+        priority += tm_slot_priority[TM_TEST_SLOT()];
+        if (priority > RT_THREAD_PRIORITY_MAX - 2)
+        {
+            priority = RT_THREAD_PRIORITY_MAX - 2;
+        }
+    }
+#endif
+
+    tm_test_thread[index] = rt_thread_create("metric",
                                          (void (*)(void *))entry_function,
-                                         RT_NULL,
+                                         (void *)(rt_ubase_t)thread_id,
                                          TM_TEST_STACK_SIZE,
                                          priority,
                                          20);
 
 
-    if (test_thread[thread_id] != RT_NULL)
+    if (tm_test_thread[index] != RT_NULL)
     {
+#if TM_CONCURRENT_ENABLE
+        /* The thread belongs to the slot of its creator and runs on the core of the slot.  */
+        tm_test_thread[index]->user_data = (rt_ubase_t)TM_TEST_SLOT();
+#if defined(RT_USING_SMP)
+        if ((tm_concurrent_tests != 0) && (tm_slot_cpu[TM_TEST_SLOT()] >= 0))
+        {
+            rt_thread_control(tm_test_thread[index], RT_THREAD_CTRL_BIND_CPU,
+                              (void *)(rt_ubase_t)tm_slot_cpu[TM_TEST_SLOT()]);
+        }
+#endif
+#endif
+
         /* Start and immediately suspend the thread to match Thread-Metric requirements */
-        rt_thread_startup(test_thread[thread_id]);
-        rt_thread_suspend(test_thread[thread_id]);
+        rt_thread_startup(tm_test_thread[index]);
+        rt_thread_suspend(tm_test_thread[index]);
         return TM_SUCCESS;
     }
     return TM_ERROR;
 }
 
 /*
- * This function resumes the specified thread.
+ * This function binds the specified thread to a CPU core. It does nothing on
+ * single core builds.
  * Returns TM_SUCCESS on success, TM_ERROR on failure.
  */
-int tm_thread_resume(int thread_id)
+int tm_thread_bind(int thread_id, int cpu)
 {
-    rt_err_t result = rt_thread_resume(test_thread[thread_id]);
+#if defined(RT_USING_SMP)
+    rt_err_t result = rt_thread_control(tm_test_thread[TM_TEST_INDEX(thread_id, TM_TEST_NUM_THREADS)],
+                                        RT_THREAD_CTRL_BIND_CPU, (void *)(rt_ubase_t)cpu);
     return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+#else
+    (void)thread_id;
+    return (cpu == 0) ? TM_SUCCESS : TM_ERROR;
+#endif
 }
 
 /*
- * This function suspends the specified thread.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * This function returns the number of CPU cores the tests can use.
  */
-int tm_thread_suspend(int thread_id)
+int tm_cpu_count(void)
 {
-    rt_err_t result = rt_thread_suspend(test_thread[thread_id]);
-    rt_schedule();
-    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+#if defined(RT_USING_SMP)
+    return RT_CPUS_NR;
+#else
+    return 1;
+#endif
 }
 
 /*
- * This function relinquishes control to other ready threads of the same priority.
+ * This function suspends the calling thread for the specified number of seconds.
  */
-void tm_thread_relinquish(void)
+void tm_thread_sleep(int seconds)
 {
-    rt_thread_yield();
+    rt_thread_mdelay(seconds * 1000); /* Convert seconds to milliseconds */
 }
 
 /*
- * This function suspends the calling thread for the specified number of seconds.
+ * This function suspends the calling thread for the specified number of milliseconds.
  */
-void tm_thread_sleep(int seconds)
+void tm_thread_sleep_ms(int milliseconds)
 {
-    rt_thread_mdelay(seconds * 1000); /* Convert seconds to milliseconds */
+    rt_thread_mdelay(milliseconds);
 }
 
 /*
- * This function creates a message queue with the specified ID.
- * The queue should hold at least one 16-byte message.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * Define the free-running timestamp counter. The core cycle counter is used
+ * where the architecture provides one, otherwise the generic timer or, as a
+ * last resort, the OS tick.
  */
-int tm_queue_create(int queue_id)
+#if defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7) || \
+    defined(ARCH_ARM_CORTEX_M33) || defined(ARCH_ARM_CORTEX_M55) || defined(ARCH_ARM_CORTEX_M85)
+#define TM_TIMESTAMP_DWT
+#define TM_DWT_CTRL   (*(volatile rt_uint32_t *)0xE0001000)
+#define TM_DWT_CYCCNT (*(volatile rt_uint32_t *)0xE0001004)
+#define TM_DEMCR      (*(volatile rt_uint32_t *)0xE000EDFC)
+#elif defined(ARCH_ARMV8) || defined(ARCH_RISCV)
+#define TM_TIMESTAMP_TIMER
+#endif
+
+static unsigned long tm_timestamp_hz;
+
+#if defined(TM_TIMESTAMP_DWT)
+static rt_uint32_t tm_timestamp_last;
+static unsigned long long tm_timestamp_high;
+#endif
+
+/*
+ * This function returns the current value of the timestamp counter. The
+ * 32-bit DWT cycle counter is extended in software, so it must be read at
+ * least once per wrap period.
+ */
+unsigned long long tm_timestamp_get(void)
 {
-    rt_err_t result = rt_mq_init(&test_msgq[queue_id], "metric_mq", &test_msgq_buffer[queue_id][0][0],
-                                 16, sizeof(test_msgq_buffer[queue_id]), RT_IPC_FLAG_PRIO);
-    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+#if defined(TM_TIMESTAMP_DWT)
+    rt_base_t level;
+    rt_uint32_t now;
+    unsigned long long result;
+
+    if ((TM_DWT_CTRL & 1) == 0)
+    {
+        TM_DEMCR |= (1UL << 24);
+        TM_DWT_CYCCNT = 0;
+        TM_DWT_CTRL |= 1;
+    }
+
+    level = rt_hw_interrupt_disable();
+    now = TM_DWT_CYCCNT;
+    if (now < tm_timestamp_last)
+    {
+        tm_timestamp_high += 0x100000000ULL;
+    }
+    tm_timestamp_last = now;
+    result = tm_timestamp_high + now;
+    rt_hw_interrupt_enable(level);
+
+    return result;
+#elif defined(TM_TIMESTAMP_TIMER) && defined(ARCH_ARMV8)
+    unsigned long long value;
+
+    __asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#elif defined(TM_TIMESTAMP_TIMER) && defined(ARCH_CPU_64BIT)
+    unsigned long long value;
+
+    __asm volatile("rdtime %0" : "=r"(value));
+    return value;
+#elif defined(TM_TIMESTAMP_TIMER)
+    rt_uint32_t high, low, check;
+
+    do
+    {
+        __asm volatile("rdtimeh %0" : "=r"(high));
+        __asm volatile("rdtime %0" : "=r"(low));
+        __asm volatile("rdtimeh %0" : "=r"(check));
+    } while (high != check);
+
+    return ((unsigned long long)high << 32) | low;
+#else
+    return rt_tick_get();
+#endif
 }
 
 /*
- * This function sends a 16-byte message to the specified queue.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * This function returns the frequency of the timestamp counter in Hz. Unless
+ * the architecture reports it, it is measured once against the OS tick.
  */
-int tm_queue_send(int queue_id, unsigned long *message_ptr)
+unsigned long tm_timestamp_frequency(void)
 {
-    rt_err_t result = rt_mq_send(&test_msgq[queue_id], message_ptr, 16);
-    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+    if (tm_timestamp_hz != 0)
+    {
+        return tm_timestamp_hz;
+    }
+
+#if defined(TM_TIMESTAMP_TIMER) && defined(ARCH_ARMV8)
+    {
+        unsigned long long value;
+
+        __asm volatile("mrs %0, cntfrq_el0" : "=r"(value));
+        tm_timestamp_hz = (unsigned long)value;
+    }
+#elif defined(TM_TIMESTAMP_DWT) || defined(TM_TIMESTAMP_TIMER)
+    {
+        rt_tick_t tick;
+        unsigned long long start;
+
+        /* Align to a tick edge, then count over a tenth of a second.  */
+        tick = rt_tick_get();
+        while (rt_tick_get() == tick);
+        start = tm_timestamp_get();
+        tick = rt_tick_get();
+        rt_thread_delay(RT_TICK_PER_SECOND / 10);
+        tm_timestamp_hz = (unsigned long)((tm_timestamp_get() - start) * RT_TICK_PER_SECOND /
+                                          (rt_tick_get() - tick));
+    }
+#else
+    tm_timestamp_hz = RT_TICK_PER_SECOND;
+#endif
+
+    return tm_timestamp_hz;
+}
+
+/* Define the sampler thread and its parameters.  */
+static rt_thread_t tm_sampler_thread;
+static int tm_sampler_period_ms;
+static void (*tm_sampler_function)(void);
+
+static void tm_sampler_entry(void *parameter)
+{
+    rt_tick_t tick;
+
+    (void)parameter;
+
+    tick = rt_tick_get();
+    while (1)
+    {
+        /* Wake up at a fixed rate, independent of the time spent sampling.  */
+        rt_thread_delay_until(&tick, rt_tick_from_millisecond(tm_sampler_period_ms));
+        tm_sampler_function();
+    }
 }
 
 /*
- * This function receives a 16-byte message from the specified queue.
+ * This function starts a thread at the specified priority that calls
+ * sample_function every period_ms milliseconds.
  * Returns TM_SUCCESS on success, TM_ERROR on failure.
  */
-int tm_queue_receive(int queue_id, unsigned long *message_ptr)
+int tm_sampler_start(int priority, int period_ms, void (*sample_function)(void))
 {
-    rt_err_t result = rt_mq_recv(&test_msgq[queue_id], message_ptr, 16, RT_WAITING_NO);
-    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+    tm_sampler_period_ms = period_ms;
+    tm_sampler_function = sample_function;
+    tm_sampler_thread = rt_thread_create("tm_samp", tm_sampler_entry, RT_NULL,
+                                         TM_TEST_STACK_SIZE, priority, 20);
+    if (tm_sampler_thread == RT_NULL)
+    {
+        return TM_ERROR;
+    }
+
+#if TM_CONCURRENT_ENABLE
+    /* The sampler acts on the threads of the test that started it.  */
+    tm_sampler_thread->user_data = (rt_ubase_t)TM_TEST_SLOT();
+#endif
+
+    rt_thread_startup(tm_sampler_thread);
+    return TM_SUCCESS;
 }
 
 /*
- * This function creates a binary semaphore with the specified ID.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * This function stops the sampler thread.
  */
-int tm_semaphore_create(int semaphore_id)
+void tm_sampler_stop(void)
 {
-    test_sem[semaphore_id] = rt_sem_create("metric_sem", 1, RT_IPC_FLAG_PRIO);
-    return (test_sem[semaphore_id] != RT_NULL) ? TM_SUCCESS : TM_ERROR;
+    if (tm_sampler_thread != RT_NULL)
+    {
+        rt_thread_delete(tm_sampler_thread);
+        tm_sampler_thread = RT_NULL;
+    }
 }
 
 /*
- * This function gets the specified semaphore.
+ * This function creates a message queue with the specified ID.
+ * The queue should hold at least one 16-byte message.
  * Returns TM_SUCCESS on success, TM_ERROR on failure.
  */
-int tm_semaphore_get(int semaphore_id)
+int tm_queue_create(int queue_id)
 {
-    rt_err_t result = rt_sem_take(test_sem[semaphore_id], RT_WAITING_FOREVER);
+    int index = TM_TEST_INDEX(queue_id, TM_TEST_NUM_MESSAGE_QUEUES);
+    rt_err_t result = rt_mq_init(&tm_test_msgq[index], "metric_mq", &test_msgq_buffer[index][0][0],
+                                 16, sizeof(test_msgq_buffer[index]), RT_IPC_FLAG_PRIO);
+    test_msgq_created[index] = (result == RT_EOK);
     return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
 }
 
 /*
- * This function releases the specified semaphore.
+ * This function creates a binary semaphore with the specified ID.
  * Returns TM_SUCCESS on success, TM_ERROR on failure.
  */
-int tm_semaphore_put(int semaphore_id)
+int tm_semaphore_create(int semaphore_id)
 {
-    rt_err_t result = rt_sem_release(test_sem[semaphore_id]);
-    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+    int index = TM_TEST_INDEX(semaphore_id, TM_TEST_NUM_SEMAPHORES);
+
+    tm_test_sem[index] = rt_sem_create("metric_sem", 1, RT_IPC_FLAG_PRIO);
+    return (tm_test_sem[index] != RT_NULL) ? TM_SUCCESS : TM_ERROR;
 }
 
 /*
@@ -207,39 +418,79 @@ void tm_cause_interrupt(void)
  */
 int tm_memory_pool_create(int pool_id)
 {
-    rt_err_t result = rt_mp_init(&test_slab[pool_id], "test_mp", &test_slab_buffer[pool_id][0],
-                                 sizeof(test_slab_buffer[pool_id]), 128);
+    int index = TM_TEST_INDEX(pool_id, TM_TEST_NUM_SLABS);
+    rt_err_t result = rt_mp_init(&tm_test_slab[index], "test_mp", &test_slab_buffer[index][0],
+                                 sizeof(test_slab_buffer[index]), 128);
+    test_slab_created[index] = (result == RT_EOK);
     return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
 }
 
 /*
- * This function allocates a 128-byte block from the specified memory pool.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * This function deletes all threads created by the test.
  */
-int tm_memory_pool_allocate(int pool_id, unsigned char **memory_ptr)
+void tm_thread_detach(void)
 {
-    *memory_ptr = (unsigned char *)rt_mp_alloc(&test_slab[pool_id], RT_WAITING_NO);
-    return (*memory_ptr != RT_NULL) ? TM_SUCCESS : TM_ERROR;
+    int first = TM_TEST_INDEX(0, TM_TEST_NUM_THREADS);
+    int i = 0;
+    for (i = first; i < first + TM_TEST_NUM_THREADS; i++)
+    {
+        if (tm_test_thread[i] != RT_NULL)
+        {
+            rt_thread_delete(tm_test_thread[i]);
+            tm_test_thread[i] = RT_NULL;
+        }
+    }
 }
 
 /*
- * This function releases a 128-byte block back to the specified memory pool.
- * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ * This function deletes all threads created by the test and lets them leave
+ * their cores, so that the test can then free the objects they used.
  */
-int tm_memory_pool_deallocate(int pool_id, unsigned char *memory_ptr)
+void tm_thread_detach_wait(void)
 {
-    rt_mp_free(memory_ptr);
-    return TM_SUCCESS;
+    tm_thread_detach();
+    rt_thread_mdelay(10);
 }
 
-void tm_thread_detach(void)
+/*
+ * This function releases every object created by the test: its threads
+ * first, so that nothing is blocked on the objects, then its semaphores,
+ * message queues and memory pools.
+ */
+void tm_teardown(void)
 {
-    int i = 0;
-    for (i = 0; i < TM_TEST_NUM_THREADS; i++)
+    int first;
+    int i;
+
+    tm_thread_detach();
+
+    first = TM_TEST_INDEX(0, TM_TEST_NUM_SEMAPHORES);
+    for (i = first; i < first + TM_TEST_NUM_SEMAPHORES; i++)
+    {
+        if (tm_test_sem[i] != RT_NULL)
+        {
+            rt_sem_delete(tm_test_sem[i]);
+            tm_test_sem[i] = RT_NULL;
+        }
+    }
+
+    first = TM_TEST_INDEX(0, TM_TEST_NUM_MESSAGE_QUEUES);
+    for (i = first; i < first + TM_TEST_NUM_MESSAGE_QUEUES; i++)
     {
-        if((test_thread[i])->stack_addr != NULL)
+        if (test_msgq_created[i])
         {
-            rt_thread_delete(test_thread[i]);
+            rt_mq_detach(&tm_test_msgq[i]);
+            test_msgq_created[i] = 0;
+        }
+    }
+
+    first = TM_TEST_INDEX(0, TM_TEST_NUM_SLABS);
+    for (i = first; i < first + TM_TEST_NUM_SLABS; i++)
+    {
+        if (test_slab_created[i])
+        {
+            rt_mp_detach(&tm_test_slab[i]);
+            test_slab_created[i] = 0;
         }
     }
 }
@@ -271,55 +522,433 @@ void SVC_Handler(void)
 #endif
 }
 
+/* Define the benchmark controller thread and its state */
+static rt_thread_t tm_controller_thread;
+static volatile int tm_controller_running;
+static volatile int tm_controller_loop;
+static int tm_controller_loops;
+
+/*
+ * Define the number of tests run by the controller, the optional ones only when
+ * enabled. The run time is not shown: warm-up, adaptive windows, the sweep
+ * and the tests with several variants measure more than one period each.
+ */
+#if defined(RT_USING_SMP)
+#define TM_CONTROLLER_SMP_TESTCASES (TM_PARALLEL_ENABLE + TM_IPI_ENABLE + TM_MIGRATION_ENABLE)
+#else
+#define TM_CONTROLLER_SMP_TESTCASES 0
+#endif
+#define TM_CONTROLLER_TESTCASES (TM_MEMORY_ALLOCATION_ID + 1 + TM_COMPUTE_ENABLE + TM_BANDWIDTH_ENABLE + \
+                                 TM_FPU_ENABLE + TM_QUEUE_COMPARISON_ENABLE + TM_POOL_COMPARISON_ENABLE + \
+                                 TM_SEMAPHORE_COMPARISON_ENABLE + TM_ATOMIC_ENABLE + TM_SPINLOCK_ENABLE + \
+                                 TM_FALSE_SHARING_ENABLE + TM_CONTROLLER_SMP_TESTCASES)
+
+/*
+ * This function runs the suite from the controller thread.
+ */
+static void tm_controller_entry(void *parameter)
+{
+    int loop;
+
+    (void)parameter;
+
+    printf("\n+--------------------------Thread-Metric for RT-Thread----------------------------+\n");
+    printf("\n+------------------Testcases: %-3d period: %-5d s per measurement-----------------+\n",
+           TM_CONTROLLER_TESTCASES, TM_TEST_DURATION_VALUE);
+    printf("+---------------------------Porting layer: %-11s----------------------------+\n",
+           TM_PORTING_LAYER_INLINE ? "inline" : "out-of-line");
+#if TM_CALIBRATION_ENABLE
+    tm_calibration_main();
+#endif
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("|                  TESTCASE                |period total| period/ ms |   os tick  |\n");
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    tm_teardown_leaks = 0;
+    for (loop = 1; loop <= tm_controller_loops; loop++)
+    {
+        tm_controller_loop = loop;
+        if (tm_controller_loops > 1)
+        {
+            printf("| %-40s | %-10d | %-10d | %-10s |\n", "Soak iteration", loop, tm_controller_loops, "");
+        }
+        tm_basic_processing_main();
+        tm_cooperative_scheduling_main();
+        tm_preemptive_scheduling_main();
+        tm_interrupt_processing_main();
+        tm_interrupt_preemption_processing_main();
+        tm_message_processing_main();
+        tm_synchronization_processing_main();
+        tm_memory_allocation_main();
+#if TM_COMPUTE_ENABLE
+        tm_compute_processing_main();
+#endif
+#if TM_PARALLEL_ENABLE && defined(RT_USING_SMP)
+        tm_parallel_processing_main();
+#endif
+#if TM_BANDWIDTH_ENABLE
+        tm_memory_bandwidth_main();
+#endif
+#if TM_FPU_ENABLE
+        tm_fpu_scheduling_main();
+#endif
+#if TM_QUEUE_COMPARISON_ENABLE
+        tm_queue_comparison_main();
+#endif
+#if TM_POOL_COMPARISON_ENABLE
+        tm_pool_comparison_main();
+#endif
+#if TM_SEMAPHORE_COMPARISON_ENABLE
+        tm_semaphore_comparison_main();
+#endif
+#if TM_ATOMIC_ENABLE
+        tm_atomic_operations_main();
+#endif
+#if TM_SPINLOCK_ENABLE
+        tm_spinlock_main();
+#endif
+#if TM_IPI_ENABLE && defined(RT_USING_SMP)
+        tm_ipi_latency_main();
+#endif
+#if TM_MIGRATION_ENABLE && defined(RT_USING_SMP)
+        tm_thread_migration_main();
+#endif
+#if TM_FALSE_SHARING_ENABLE
+        tm_false_sharing_main();
+#endif
+        printf("+------------------------------------------+------------+------------+------------+\n");
+    }
+    if (tm_controller_loops > 1)
+    {
+        printf("| %-40s | %-10lu | %-10s | %-10s |\n", "Soak tests with heap leaks", tm_teardown_leaks, "", "");
+        printf("+------------------------------------------+------------+------------+------------+\n");
+    }
+
+    tm_controller_running = 0;
+}
+
+#if TM_CONCURRENT_ENABLE
+/* Define the tests that can run at once, the eight Thread-Metric tests indexed by their identifier */
+static int (*const tm_concurrent_test_main[TM_MEMORY_ALLOCATION_ID + 1])(void) =
+{
+    tm_basic_processing_main,
+    tm_cooperative_scheduling_main,
+    tm_preemptive_scheduling_main,
+    tm_interrupt_processing_main,
+    tm_interrupt_preemption_processing_main,
+    tm_message_processing_main,
+    tm_synchronization_processing_main,
+    tm_memory_allocation_main,
+};
+
+/* Define the test of each slot, its isolated throughput and the completion of the runners */
+static int tm_concurrent_test[TM_TEST_NUM_SLOTS];
+static unsigned long long tm_concurrent_baseline[TM_TEST_NUM_SLOTS];
+static struct rt_semaphore tm_concurrent_done;
+
+/*
+ * This function runs the test of a slot. It runs in a thread of the slot, so
+ * that the test uses the objects of the slot.
+ */
+static void tm_concurrent_runner_entry(void *parameter)
+{
+    (void)parameter;
+
+    tm_concurrent_test_main[tm_concurrent_test[TM_TEST_SLOT()]]();
+    rt_sem_release(&tm_concurrent_done);
+}
+
+/*
+ * This function runs the tests of the specified slots at once and waits for
+ * all of them to finish.
+ */
+static void tm_concurrent_run(int first, int count)
+{
+    rt_thread_t runner;
+    int started = 0;
+    int slot;
+
+    for (slot = first; slot < first + count; slot++)
+    {
+        runner = rt_thread_create("tm_run", tm_concurrent_runner_entry, RT_NULL,
+                                  TM_CONTROLLER_STACK_SIZE, TM_CONTROLLER_PRIORITY, 20);
+        if (runner == RT_NULL)
+        {
+            printf("ERROR: No runner thread for the %s!\n", tm_measure_test_name(tm_concurrent_test[slot]));
+            continue;
+        }
+
+        runner->user_data = (rt_ubase_t)slot;
+#if defined(RT_USING_SMP)
+        if (TM_CONTROLLER_CPU >= 0)
+        {
+            rt_thread_control(runner, RT_THREAD_CTRL_BIND_CPU, (void *)(rt_ubase_t)TM_CONTROLLER_CPU);
+        }
+#endif
+        rt_thread_startup(runner);
+        started++;
+    }
+
+    while (started-- > 0)
+    {
+        rt_sem_take(&tm_concurrent_done, RT_WAITING_FOREVER);
+    }
+}
+
+/*
+ * This function runs the selected tests from the controller thread: each
+ * alone first, for its isolated baseline, then all of them at once.
+ */
+static void tm_concurrent_entry(void *parameter)
+{
+    unsigned long long throughput;
+    unsigned long long share;
+    char baseline_buffer[16];
+    char throughput_buffer[16];
+    char share_buffer[16];
+    int slot;
+
+    (void)parameter;
+
+    printf("\n+--------------------------Thread-Metric for RT-Thread----------------------------+\n");
+    printf("\n+------------------Testcases: %-3d period: %-5d s per measurement-----------------+\n",
+           tm_concurrent_tests, TM_TEST_DURATION_VALUE);
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "Concurrent tests", "core", "priority +", "");
+    for (slot = 0; slot < tm_concurrent_tests; slot++)
+    {
+        snprintf(baseline_buffer, sizeof(baseline_buffer), "%d", tm_slot_cpu[slot]);
+        printf("|   %-38s | %-10s | %-10d | %-10s |\n", tm_measure_test_name(tm_concurrent_test[slot]),
+               (tm_slot_cpu[slot] < 0) ? "any" : baseline_buffer, tm_slot_priority[slot], "");
+    }
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("|                  TESTCASE                |period total| period/ ms |   os tick  |\n");
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    tm_teardown_leaks = 0;
+    rt_sem_init(&tm_concurrent_done, "tm_done", 0, RT_IPC_FLAG_PRIO);
+
+    /* Measure each test alone, with the placement it has when they run at once.  */
+    for (slot = 0; slot < tm_concurrent_tests; slot++)
+    {
+        tm_concurrent_run(slot, 1);
+        tm_concurrent_baseline[slot] = tm_measure_throughput(tm_concurrent_test[slot]);
+    }
+
+    /* Run all of them at once; their rows follow in the order they finish.  */
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    tm_concurrent_active = 1;
+    tm_concurrent_run(0, tm_concurrent_tests);
+    tm_concurrent_active = 0;
+    rt_sem_detach(&tm_concurrent_done);
+
+    /* Show the throughput of each test at once next to its isolated baseline.  */
+    printf("+------------------------------------------+------------+------------+------------+\n");
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "ops/ms of each test", "isolated", "concurrent", "% isolated");
+    for (slot = 0; slot < tm_concurrent_tests; slot++)
+    {
+        throughput = tm_measure_throughput(tm_concurrent_test[slot]);
+        share = (tm_concurrent_baseline[slot] != 0) ? throughput * 10000 / tm_concurrent_baseline[slot] : 0;
+        printf("|   %-38s | %-10s | %-10s | %-10s |\n", tm_measure_test_name(tm_concurrent_test[slot]),
+               (tm_concurrent_baseline[slot] != 0) ?
+               tm_measure_format(baseline_buffer, sizeof(baseline_buffer), tm_concurrent_baseline[slot]) : "FAILED",
+               (throughput != 0) ? tm_measure_format(throughput_buffer, sizeof(throughput_buffer), throughput) : "FAILED",
+               ((tm_concurrent_baseline[slot] != 0) && (throughput != 0)) ?
+               tm_measure_format(share_buffer, sizeof(share_buffer), share) : "-");
+    }
+    printf("+------------------------------------------+------------+------------+------------+\n");
+
+    /* Leave the slots to the suite.  */
+    tm_concurrent_tests = 0;
+    tm_controller_running = 0;
+}
+
+/*
+ * This function parses the tests to run at once, each given as
+ * test[:core[:priority]]: the test identifier from 0 to 7, the core its
+ * threads are bound to, -1 for any, and the offset added to the priority of
+ * its threads. The interrupt tests share the software interrupt and cannot
+ * run together.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+#define TM_CONCURRENT_INTERRUPT(test) (((test) == TM_INTERRUPT_PROCESSING_ID) || \
+                                       ((test) == TM_INTERRUPT_PREEMPTION_PROCESSING_ID))
+
+static int tm_concurrent_parse(int argc, char *argv[])
+{
+    char *end;
+    int slot;
+    int i;
+
+    if ((argc < 1) || (argc > TM_TEST_NUM_SLOTS))
+    {
+        return TM_ERROR;
+    }
+
+    for (slot = 0; slot < argc; slot++)
+    {
+        tm_concurrent_test[slot] = (int)strtol(argv[slot], &end, 10);
+        tm_slot_cpu[slot] = -1;
+        tm_slot_priority[slot] = 0;
+        if (*end == ':')
+        {
+            tm_slot_cpu[slot] = (int)strtol(end + 1, &end, 10);
+        }
+        if (*end == ':')
+        {
+            tm_slot_priority[slot] = (int)strtol(end + 1, &end, 10);
+        }
+
+        if ((*end != '\0') || (end == argv[slot]) ||
+            (tm_concurrent_test[slot] < 0) || (tm_concurrent_test[slot] > TM_MEMORY_ALLOCATION_ID) ||
+            (tm_slot_cpu[slot] < -1) || (tm_slot_cpu[slot] >= tm_cpu_count()) ||
+            (tm_slot_priority[slot] < 0) || (tm_slot_priority[slot] >= RT_THREAD_PRIORITY_MAX))
+        {
+            return TM_ERROR;
+        }
+
+        for (i = 0; i < slot; i++)
+        {
+            if ((tm_concurrent_test[i] == tm_concurrent_test[slot]) ||
+                (TM_CONCURRENT_INTERRUPT(tm_concurrent_test[i]) && TM_CONCURRENT_INTERRUPT(tm_concurrent_test[slot])))
+            {
+                return TM_ERROR;
+            }
+        }
+    }
+
+    tm_concurrent_tests = argc;
+    return TM_SUCCESS;
+}
+#endif
+
+/*
+ * This function returns nonzero while several tests run at once. The heap
+ * and the sampler of the measurement helpers are then shared by the tests.
+ */
+int tm_concurrent_running(void)
+{
+#if TM_CONCURRENT_ENABLE
+    return tm_concurrent_active;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * This function starts the controller thread with the specified entry.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+static int tm_controller_start(void (*entry)(void *), int loops)
+{
+    if (tm_controller_running)
+    {
+        return TM_ERROR;
+    }
+
+    tm_controller_loops = loops;
+    tm_controller_loop = 0;
+    tm_controller_thread = rt_thread_create("tm_ctrl", entry, RT_NULL,
+                                            TM_CONTROLLER_STACK_SIZE, TM_CONTROLLER_PRIORITY, 20);
+    if (tm_controller_thread == RT_NULL)
+    {
+        return TM_ERROR;
+    }
+
+#if defined(RT_USING_SMP)
+    if (TM_CONTROLLER_CPU >= 0)
+    {
+        rt_thread_control(tm_controller_thread, RT_THREAD_CTRL_BIND_CPU, (void *)(rt_ubase_t)TM_CONTROLLER_CPU);
+    }
+#endif
+
+    tm_controller_running = 1;
+    rt_thread_startup(tm_controller_thread);
+    return TM_SUCCESS;
+}
+
 void thread_metric(int argc, char *argv[])
 {
-    rt_err_t result;
-    rt_uint8_t priority = 10;
-    rt_thread_t tshell_tid = RT_NULL;
+    int loops = 1;
 
-    if (argc == 1)
+    if ((argc > 1) && (strcmp(argv[1], "status") == 0))
     {
-        TM_TEST_DURATION_VALUE = TM_TEST_DURATION;
-        printf("period:%dms You also can input: thread_metric num [num equal period]\n", TM_TEST_DURATION_VALUE);
+        if (tm_controller_running)
+        {
+            printf("thread metric running, loop %d of %d\n", tm_controller_loop, tm_controller_loops);
+            tm_measure_status();
+        }
+        else
+        {
+            printf("thread metric idle\n");
+        }
+        return;
     }
-    else if (argv[1] != RT_NULL)
+
+    if ((argc > 1) && (strcmp(argv[1], "result") == 0))
     {
-        TM_TEST_DURATION_VALUE = atoi(argv[1]);
+        tm_measure_summary();
+        return;
     }
-    else
+
+    if (tm_controller_running)
     {
-        printf("please input:thread_metric\n");
+        printf("thread metric is already running, see: thread_metric status\n");
+        return;
     }
 
-    tshell_tid = rt_thread_find("tshell");
-    if (tshell_tid != RT_NULL)
+    if ((argc > 1) && (strcmp(argv[1], "concurrent") == 0))
     {
-        result = rt_thread_control(tshell_tid, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+#if TM_CONCURRENT_ENABLE
+        if (tm_concurrent_parse(argc - 2, &argv[2]) != TM_SUCCESS)
+        {
+            printf("please input: thread_metric concurrent test[:core[:priority]] ..., up to %d tests of 0-%d\n",
+                   TM_TEST_NUM_SLOTS, TM_MEMORY_ALLOCATION_ID);
+            return;
+        }
+
+        /* Keep the period of the last run, if any.  */
+        if (TM_TEST_DURATION_VALUE == 0)
+        {
+            TM_TEST_DURATION_VALUE = TM_TEST_DURATION;
+        }
+
+        if (tm_controller_start(tm_concurrent_entry, 1) != TM_SUCCESS)
+        {
+            tm_concurrent_tests = 0;
+            printf("thread metric failed\n");
+        }
+#else
+        printf("thread metric concurrent needs TM_CONCURRENT_ENABLE\n");
+#endif
+        return;
     }
 
-    if (result == RT_EOK)
+    if (argc == 1)
     {
-        printf("\n+--------------------------Thread-Metric for RT-Thread----------------------------+\n");
-        printf("\n+----------------------------Testcase will run %d ms------------------------------+\n", TM_TEST_DURATION_VALUE * CONFIG_TESTCASE_NUM);
-        printf("+------------------------------------------+------------+------------+------------+\n");
-        printf("|                  TESTCASE                |period total| period/ ms |   os tick  |\n");
-        printf("+------------------------------------------+------------+------------+------------+\n");
-        tm_basic_processing_main();
-        tm_cooperative_scheduling_main();
-        tm_preemptive_scheduling_main();
-        tm_interrupt_processing_main();
-        tm_interrupt_preemption_processing_main();
-        tm_message_processing_main();
-        tm_synchronization_processing_main();
-        tm_memory_allocation_main();
-        printf("+------------------------------------------+------------+------------+------------+\n");
+        TM_TEST_DURATION_VALUE = TM_TEST_DURATION;
+        printf("period:%dms You also can input: thread_metric num [loops] [num equal period, loops repeat the suite]\n", TM_TEST_DURATION_VALUE);
+        printf("                                thread_metric status|result\n");
+#if TM_CONCURRENT_ENABLE
+        printf("                                thread_metric concurrent test[:core[:priority]] ...\n");
+#endif
+    }
+    else if (argv[1] != RT_NULL)
+    {
+        TM_TEST_DURATION_VALUE = atoi(argv[1]);
+
+        /* An optional second argument repeats the suite as a soak test.  */
+        if ((argc > 2) && (atoi(argv[2]) > 0))
+        {
+            loops = atoi(argv[2]);
+        }
     }
     else
     {
-        printf("thread metric failed\n");
+        printf("please input:thread_metric\n");
     }
 
-    priority = 20;
-    rt_thread_control(tshell_tid, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+    if (tm_controller_start(tm_controller_entry, loops) != TM_SUCCESS)
+    {
+        printf("thread metric failed\n");
+    }
 }
 MSH_CMD_EXPORT(thread_metric, Thread-Metric for RT-Thread)
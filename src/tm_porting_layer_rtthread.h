@@ -0,0 +1,170 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** Thread-Metric Component                                               */
+/**                                                                       */
+/**   Porting Layer for RT-Thread RTOS, measured path services            */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+/*
+ * The services in this file are called from inside the measured loops of the
+ * tests. When TM_PORTING_LAYER_INLINE is set they are included by tm_api.h
+ * as static inline functions, otherwise tm_porting_layer_rtthread.c includes
+ * them once with external linkage.
+ */
+
+#ifndef TM_PORTING_LAYER_RTTHREAD_H
+#define TM_PORTING_LAYER_RTTHREAD_H
+
+#include <rtthread.h>
+
+#ifndef TM_PORT_API
+#define TM_PORT_API rt_inline
+#endif
+
+/* Define constants for the test suite */
+#define TM_TEST_NUM_THREADS        10
+#define TM_TEST_STACK_SIZE         1024
+#define TM_TEST_NUM_SEMAPHORES     4
+#define TM_TEST_NUM_MESSAGE_QUEUES 4
+#define TM_TEST_NUM_SLABS          4
+
+/*
+ * Define the slots of the tests that run at once, see TM_CONCURRENT_ENABLE.
+ * Each slot has its own threads, semaphores, message queues and memory pools;
+ * the slot of the calling test is kept in the user data of its threads.
+ */
+#if TM_CONCURRENT_ENABLE
+#define TM_TEST_NUM_SLOTS          TM_CONCURRENT_MAX_TESTS
+#define TM_TEST_SLOT()             ((int)rt_thread_self()->user_data)
+#else
+#define TM_TEST_NUM_SLOTS          1
+#define TM_TEST_SLOT()             0
+#endif
+
+/* Define the index of an object of the calling test in the tables below */
+#define TM_TEST_INDEX(id, count)   (TM_TEST_SLOT() * (count) + (id))
+
+/* Define thread control blocks, semaphores, message queues and memory pools */
+extern rt_thread_t tm_test_thread[TM_TEST_NUM_SLOTS * TM_TEST_NUM_THREADS];
+extern rt_sem_t tm_test_sem[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SEMAPHORES];
+extern struct rt_messagequeue tm_test_msgq[TM_TEST_NUM_SLOTS * TM_TEST_NUM_MESSAGE_QUEUES];
+extern struct rt_mempool tm_test_slab[TM_TEST_NUM_SLOTS * TM_TEST_NUM_SLABS];
+
+/*
+ * This function resumes the specified thread.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_thread_resume(int thread_id)
+{
+    rt_err_t result = rt_thread_resume(tm_test_thread[TM_TEST_INDEX(thread_id, TM_TEST_NUM_THREADS)]);
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function suspends the specified thread.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_thread_suspend(int thread_id)
+{
+    rt_err_t result = rt_thread_suspend(tm_test_thread[TM_TEST_INDEX(thread_id, TM_TEST_NUM_THREADS)]);
+    rt_schedule();
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function relinquishes control to other ready threads of the same priority.
+ */
+TM_PORT_API void tm_thread_relinquish(void)
+{
+    rt_thread_yield();
+}
+
+/*
+ * This function sends a 16-byte message to the specified queue.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_queue_send(int queue_id, unsigned long *message_ptr)
+{
+    rt_err_t result = rt_mq_send(&tm_test_msgq[TM_TEST_INDEX(queue_id, TM_TEST_NUM_MESSAGE_QUEUES)], message_ptr, 16);
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function receives a 16-byte message from the specified queue.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_queue_receive(int queue_id, unsigned long *message_ptr)
+{
+    rt_err_t result = rt_mq_recv(&tm_test_msgq[TM_TEST_INDEX(queue_id, TM_TEST_NUM_MESSAGE_QUEUES)], message_ptr, 16, RT_WAITING_NO);
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function gets the specified semaphore.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_semaphore_get(int semaphore_id)
+{
+    rt_err_t result = rt_sem_take(tm_test_sem[TM_TEST_INDEX(semaphore_id, TM_TEST_NUM_SEMAPHORES)], RT_WAITING_FOREVER);
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function releases the specified semaphore.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_semaphore_put(int semaphore_id)
+{
+    rt_err_t result = rt_sem_release(tm_test_sem[TM_TEST_INDEX(semaphore_id, TM_TEST_NUM_SEMAPHORES)]);
+    return (result == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function allocates a 128-byte block from the specified memory pool.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_memory_pool_allocate(int pool_id, unsigned char **memory_ptr)
+{
+    *memory_ptr = (unsigned char *)rt_mp_alloc(&tm_test_slab[TM_TEST_INDEX(pool_id, TM_TEST_NUM_SLABS)], RT_WAITING_NO);
+    return (*memory_ptr != RT_NULL) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * This function releases a 128-byte block back to the specified memory pool.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+TM_PORT_API int tm_memory_pool_deallocate(int pool_id, unsigned char *memory_ptr)
+{
+    rt_mp_free(memory_ptr);
+    return TM_SUCCESS;
+}
+
+/*
+ * This function stands in for a measured service while the loop skeleton of a
+ * test is calibrated. It does no RTOS work, but like the real services it acts
+ * as a compiler barrier.
+ */
+TM_PORT_API int tm_calibration_stub(int id, void *arg)
+{
+    (void)id;
+    (void)arg;
+
+    __asm volatile("" ::: "memory");
+    return TM_SUCCESS;
+}
+
+#endif
@@ -43,11 +43,11 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_preemptive_thread_0_counter;
-unsigned long tm_preemptive_thread_1_counter;
-unsigned long tm_preemptive_thread_2_counter;
-unsigned long tm_preemptive_thread_3_counter;
-unsigned long tm_preemptive_thread_4_counter;
+TM_COUNTER tm_preemptive_thread_0_counter;
+TM_COUNTER tm_preemptive_thread_1_counter;
+TM_COUNTER tm_preemptive_thread_2_counter;
+TM_COUNTER tm_preemptive_thread_3_counter;
+TM_COUNTER tm_preemptive_thread_4_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -80,6 +80,13 @@ int tm_preemptive_scheduling_main(void)
 void tm_preemptive_scheduling_initialize(void)
 {
 
+    /* Clear the counters of a previous run, the report checks them against each other.  */
+    tm_counter_reset(&tm_preemptive_thread_0_counter);
+    tm_counter_reset(&tm_preemptive_thread_1_counter);
+    tm_counter_reset(&tm_preemptive_thread_2_counter);
+    tm_counter_reset(&tm_preemptive_thread_3_counter);
+    tm_counter_reset(&tm_preemptive_thread_4_counter);
+
     /* Create thread 0 at priority 10.  */
     tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 9, tm_preemptive_thread_0_entry);
 
@@ -118,7 +125,7 @@ void tm_preemptive_thread_0_entry(void *p1, void *p2, void *p3)
          */
 
         /* Increment this thread's counter.  */
-        tm_preemptive_thread_0_counter++;
+        tm_counter_increment(&tm_preemptive_thread_0_counter);
     }
 }
 
@@ -140,7 +147,7 @@ void tm_preemptive_thread_1_entry(void *p1, void *p2, void *p3)
          */
 
         /* Increment this thread's counter.  */
-        tm_preemptive_thread_1_counter++;
+        tm_counter_increment(&tm_preemptive_thread_1_counter);
 
         /* Suspend self!  */
         tm_thread_suspend(1);
@@ -165,7 +172,7 @@ void tm_preemptive_thread_2_entry(void *p1, void *p2, void *p3)
          */
 
         /* Increment this thread's counter.  */
-        tm_preemptive_thread_2_counter++;
+        tm_counter_increment(&tm_preemptive_thread_2_counter);
 
         /* Suspend self!  */
         tm_thread_suspend(2);
@@ -190,7 +197,7 @@ void tm_preemptive_thread_3_entry(void *p1, void *p2, void *p3)
          */
 
         /* Increment this thread's counter.  */
-        tm_preemptive_thread_3_counter++;
+        tm_counter_increment(&tm_preemptive_thread_3_counter);
 
         /* Suspend self!  */
         tm_thread_suspend(3);
@@ -207,75 +214,120 @@ void tm_preemptive_thread_4_entry(void *p1, void *p2, void *p3)
     while (1) {
 
         /* Increment this thread's counter.  */
-        tm_preemptive_thread_4_counter++;
+        tm_counter_increment(&tm_preemptive_thread_4_counter);
 
         /* Self suspend thread 4.  */
         tm_thread_suspend(4);
     }
 }
 
+/* Define the loop skeleton of the preemptive threads, with the RTOS services stubbed out.  */
+static TM_COUNTER tm_preemptive_skeleton_counter[5];
+
+static void tm_preemptive_skeleton(unsigned long iterations)
+{
+    /* Each round runs one loop iteration of all 5 threads.  */
+    for (iterations = iterations / 5; iterations != 0; iterations--) {
+
+        /* Thread 0 resumes thread 1.  */
+        tm_calibration_stub(1, 0);
+
+        /* Threads 1 to 3 resume the next thread.  */
+        tm_calibration_stub(2, 0);
+        tm_calibration_stub(3, 0);
+        tm_calibration_stub(4, 0);
+
+        /* Thread 4 increments its counter and self-suspends.  */
+        tm_counter_increment(&tm_preemptive_skeleton_counter[4]);
+        tm_calibration_stub(4, 0);
+
+        /* Threads 3 to 1 increment their counters and self-suspend.  */
+        tm_counter_increment(&tm_preemptive_skeleton_counter[3]);
+        tm_calibration_stub(3, 0);
+        tm_counter_increment(&tm_preemptive_skeleton_counter[2]);
+        tm_calibration_stub(2, 0);
+        tm_counter_increment(&tm_preemptive_skeleton_counter[1]);
+        tm_calibration_stub(1, 0);
+
+        /* Thread 0 increments its counter.  */
+        tm_counter_increment(&tm_preemptive_skeleton_counter[0]);
+    }
+}
+
+/* Define the preemptive test calibration function.  */
+void tm_preemptive_scheduling_calibrate(void)
+{
+    tm_calibrate(TM_PREEMPTIVE_SCHEDULING_ID, tm_preemptive_skeleton);
+}
+
+/* Define the preemptive test counter read function.  */
+static unsigned long long tm_preemptive_counter_total(void)
+{
+    /* Calculate the total of all the counters.  */
+    return tm_counter_read(&tm_preemptive_thread_0_counter) + tm_counter_read(&tm_preemptive_thread_1_counter) +
+        tm_counter_read(&tm_preemptive_thread_2_counter) + tm_counter_read(&tm_preemptive_thread_3_counter) +
+        tm_counter_read(&tm_preemptive_thread_4_counter);
+}
+
 /* Define the preemptive test reporting function.  */
 void tm_preemptive_thread_report(void)
 {
 
-    unsigned long total;
+    unsigned long long counter[5];
+    unsigned long long total;
+    unsigned long long average;
+    unsigned long period_total;
     unsigned long relative_time;
-    unsigned long last_total;
-    unsigned long average;
-
-    /* Initialize the last total.  */
-    last_total = 0;
+    int i;
 
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_total = tm_measure(TM_PREEMPTIVE_SCHEDULING_ID, tm_preemptive_counter_total);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
-        /* Calculate the total of all the counters.  */
-        total = tm_preemptive_thread_0_counter + tm_preemptive_thread_1_counter +
-            tm_preemptive_thread_2_counter + tm_preemptive_thread_3_counter +
-            tm_preemptive_thread_4_counter;
+        /* Read all the counters and calculate their total.  */
+        counter[0] = tm_counter_read(&tm_preemptive_thread_0_counter);
+        counter[1] = tm_counter_read(&tm_preemptive_thread_1_counter);
+        counter[2] = tm_counter_read(&tm_preemptive_thread_2_counter);
+        counter[3] = tm_counter_read(&tm_preemptive_thread_3_counter);
+        counter[4] = tm_counter_read(&tm_preemptive_thread_4_counter);
+        total = counter[0] + counter[1] + counter[2] + counter[3] + counter[4];
 
         /* Calculate the average of all the counters.  */
         average = total / 5;
 
         /* See if there are any errors.  */
-        if ((tm_preemptive_thread_0_counter < (average - 1)) ||
-            (tm_preemptive_thread_0_counter > (average + 1)) ||
-            (tm_preemptive_thread_1_counter < (average - 1)) ||
-            (tm_preemptive_thread_1_counter > (average + 1)) ||
-            (tm_preemptive_thread_2_counter < (average - 1)) ||
-            (tm_preemptive_thread_2_counter > (average + 1)) ||
-            (tm_preemptive_thread_3_counter < (average - 1)) ||
-            (tm_preemptive_thread_3_counter > (average + 1)) ||
-            (tm_preemptive_thread_4_counter < (average - 1)) ||
-            (tm_preemptive_thread_4_counter > (average + 1))) {
+        for (i = 0; i < 5; i++) {
+            if ((counter[i] < (average - 1)) || (counter[i] > (average + 1))) {
+                break;
+            }
+        }
+        if (i < 5) {
 
             printf("ERROR: Invalid counter value(s). Preemptive counters should not be "
                    "more that 1 different than the average!\n");
             printf("   Average: %lu, 0: %lu, 1: %lu, 2: %lu, 3: %lu, 4: %lu\n",
-                average, tm_preemptive_thread_0_counter,
-                tm_preemptive_thread_1_counter,
-                tm_preemptive_thread_2_counter,
-                tm_preemptive_thread_3_counter,
-                tm_preemptive_thread_4_counter);
+                (unsigned long)average, (unsigned long)counter[0],
+                (unsigned long)counter[1],
+                (unsigned long)counter[2],
+                (unsigned long)counter[3],
+                (unsigned long)counter[4]);
         }
 
         /* Show the time period total.  */
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Preemptive Scheduling Test",
-               total - last_total, relative_time, rt_tick_get());
-        /* Save the last total.  */
-        last_total = total;
+               period_total, relative_time, rt_tick_get());
+        tm_measure_report(TM_PREEMPTIVE_SCHEDULING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
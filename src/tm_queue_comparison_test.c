@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Queue comparison test. A producer thread sends numbered messages to a
+ * consumer thread through the lock-free SPSC ring of tm_reference.h, an
+ * rt_messagequeue and, when RT_USING_DEVICE_IPC is set, an rt_ringbuffer,
+ * for each of TM_QUEUE_COMPARISON_SIZES. Both threads poll and yield when
+ * the queue is full or empty. Each combination runs for one test period
+ * with both threads on the same core, then, on SMP builds with two cores or
+ * more, with the producer and the consumer on different cores. The consumer
+ * checks the number at both ends of every message.
+ */
+
+#include "tm_api.h"
+#include "tm_reference.h"
+
+#if defined(RT_USING_DEVICE_IPC)
+#include <rtdevice.h>
+#endif
+
+/* Define the queues, the message sizes and the placements of the threads.  */
+#define TM_QUEUE_COMPARISON_SPSC       0
+#define TM_QUEUE_COMPARISON_MQ         1
+#define TM_QUEUE_COMPARISON_RINGBUFFER 2
+#define TM_QUEUE_COMPARISON_KINDS      3
+
+#define TM_QUEUE_COMPARISON_SIZES      3
+#define TM_QUEUE_COMPARISON_MAX_BYTES  64
+#define TM_QUEUE_COMPARISON_PLACEMENTS 2
+
+/* Define the room for the message header of each rt_messagequeue slot.  */
+#define TM_QUEUE_COMPARISON_MQ_HEADER  (2 * sizeof(void *))
+
+static const unsigned long tm_queue_comparison_size[TM_QUEUE_COMPARISON_SIZES] = { 4, 16, TM_QUEUE_COMPARISON_MAX_BYTES };
+
+static const char *tm_queue_comparison_kind_name[TM_QUEUE_COMPARISON_KINDS] = {
+    "spsc ring",
+    "rt_messagequeue",
+    "rt_ringbuffer",
+};
+
+static const char *tm_queue_comparison_placement_name[TM_QUEUE_COMPARISON_PLACEMENTS] = {
+    "same core",
+    "cross core",
+};
+
+TM_COUNTER tm_queue_comparison_counter;
+
+/* Define the queues used by the test, only the one of the current variant is initialized.  */
+
+static tm_spsc_ring_t tm_queue_comparison_ring;
+static struct rt_messagequeue tm_queue_comparison_mq;
+#if defined(RT_USING_DEVICE_IPC)
+static struct rt_ringbuffer tm_queue_comparison_rb;
+#endif
+
+/* Define the queue and the message size of the current variant.  */
+
+static volatile int tm_queue_comparison_kind;
+static volatile unsigned long tm_queue_comparison_bytes;
+
+/* Set if the consumer received a message out of order or torn.  */
+static volatile int tm_queue_comparison_corrupted;
+
+/* Define the results of each variant.  */
+static unsigned long tm_queue_comparison_ops[TM_QUEUE_COMPARISON_PLACEMENTS][TM_QUEUE_COMPARISON_SIZES][TM_QUEUE_COMPARISON_KINDS];
+static unsigned long long tm_queue_comparison_cost[TM_QUEUE_COMPARISON_PLACEMENTS][TM_QUEUE_COMPARISON_SIZES][TM_QUEUE_COMPARISON_KINDS];
+static int tm_queue_comparison_status[TM_QUEUE_COMPARISON_PLACEMENTS][TM_QUEUE_COMPARISON_SIZES][TM_QUEUE_COMPARISON_KINDS];
+static int tm_queue_comparison_placements;
+
+/* Define the test thread prototypes.  */
+
+void tm_queue_comparison_thread_0_entry(void *p1, void *p2, void *p3);
+void tm_queue_comparison_thread_1_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_queue_comparison_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_queue_comparison_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_queue_comparison_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_queue_comparison_initialize);
+
+    return 0;
+}
+
+/*
+ * Send a message to the queue of the current variant without waiting.
+ * Returns TM_SUCCESS on success, TM_ERROR if the queue is full.
+ */
+static int tm_queue_comparison_put(int kind, const rt_uint32_t *message, unsigned long bytes)
+{
+    if (kind == TM_QUEUE_COMPARISON_SPSC) {
+        return tm_spsc_ring_put(&tm_queue_comparison_ring, message);
+    }
+    if (kind == TM_QUEUE_COMPARISON_MQ) {
+        return (rt_mq_send(&tm_queue_comparison_mq, message, bytes) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+    }
+#if defined(RT_USING_DEVICE_IPC)
+    if (rt_ringbuffer_space_len(&tm_queue_comparison_rb) >= bytes) {
+        rt_ringbuffer_put(&tm_queue_comparison_rb, (const rt_uint8_t *)message, bytes);
+        return TM_SUCCESS;
+    }
+#endif
+    return TM_ERROR;
+}
+
+/*
+ * Receive a message from the queue of the current variant without waiting.
+ * Returns TM_SUCCESS on success, TM_ERROR if the queue is empty.
+ */
+static int tm_queue_comparison_get(int kind, rt_uint32_t *message, unsigned long bytes)
+{
+    if (kind == TM_QUEUE_COMPARISON_SPSC) {
+        return tm_spsc_ring_get(&tm_queue_comparison_ring, message);
+    }
+    if (kind == TM_QUEUE_COMPARISON_MQ) {
+
+        /* RT-Thread 5 returns the size of the message, older versions RT_EOK.  */
+        return (rt_mq_recv(&tm_queue_comparison_mq, message, bytes, RT_WAITING_NO) >= 0) ? TM_SUCCESS : TM_ERROR;
+    }
+#if defined(RT_USING_DEVICE_IPC)
+    if (rt_ringbuffer_data_len(&tm_queue_comparison_rb) >= bytes) {
+        rt_ringbuffer_get(&tm_queue_comparison_rb, (rt_uint8_t *)message, bytes);
+        return TM_SUCCESS;
+    }
+#endif
+    return TM_ERROR;
+}
+
+/* Define the producer thread, it numbers the first and the last word of each message.  */
+void tm_queue_comparison_thread_0_entry(void *p1, void *p2, void *p3)
+{
+    rt_uint32_t message[TM_QUEUE_COMPARISON_MAX_BYTES / sizeof(rt_uint32_t)] = { 0 };
+    int kind = tm_queue_comparison_kind;
+    unsigned long bytes = tm_queue_comparison_bytes;
+    unsigned long last = bytes / sizeof(rt_uint32_t) - 1;
+    rt_uint32_t sequence = 0;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        message[0] = sequence;
+        message[last] = sequence;
+
+        /* Send the message, or let the consumer run if the queue is full.  */
+        if (tm_queue_comparison_put(kind, message, bytes) == TM_SUCCESS) {
+            sequence++;
+        } else {
+            tm_thread_relinquish();
+        }
+    }
+}
+
+/* Define the consumer thread.  */
+void tm_queue_comparison_thread_1_entry(void *p1, void *p2, void *p3)
+{
+    rt_uint32_t message[TM_QUEUE_COMPARISON_MAX_BYTES / sizeof(rt_uint32_t)];
+    int kind = tm_queue_comparison_kind;
+    unsigned long bytes = tm_queue_comparison_bytes;
+    unsigned long last = bytes / sizeof(rt_uint32_t) - 1;
+    rt_uint32_t sequence = 0;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Receive a message, or let the producer run if the queue is empty.  */
+        if (tm_queue_comparison_get(kind, message, bytes) != TM_SUCCESS) {
+            tm_thread_relinquish();
+            continue;
+        }
+
+        /* Check the message and carry on from its number if it is wrong.  */
+        if ((message[0] != sequence) || (message[last] != sequence)) {
+            tm_queue_comparison_corrupted = 1;
+            sequence = message[0];
+        }
+        sequence++;
+
+        /* Increment the number of messages received.  */
+        tm_counter_increment(&tm_queue_comparison_counter);
+    }
+}
+
+/* Define the queue comparison counter read function.  */
+static unsigned long long tm_queue_comparison_counter_read(void)
+{
+    return tm_counter_read(&tm_queue_comparison_counter);
+}
+
+/* Measure one queue for one message size and placement.  */
+static void tm_queue_comparison_variant(int placement, int size, int kind)
+{
+    unsigned long bytes = tm_queue_comparison_size[size];
+    unsigned long storage_size;
+    void *storage;
+    int status;
+
+    tm_queue_comparison_status[placement][size][kind] = TM_ERROR;
+
+#if !defined(RT_USING_DEVICE_IPC)
+    if (kind == TM_QUEUE_COMPARISON_RINGBUFFER) {
+        return;
+    }
+#endif
+
+    /* Allocate the storage of the queue for TM_QUEUE_COMPARISON_DEPTH messages and initialize it.  */
+    storage_size = TM_QUEUE_COMPARISON_DEPTH * bytes;
+    if (kind == TM_QUEUE_COMPARISON_MQ) {
+        storage_size = TM_QUEUE_COMPARISON_DEPTH * (RT_ALIGN(bytes, RT_ALIGN_SIZE) + TM_QUEUE_COMPARISON_MQ_HEADER);
+    }
+    storage = rt_malloc_align(storage_size, TM_CACHE_LINE_SIZE);
+    if (storage == RT_NULL) {
+        return;
+    }
+    if (kind == TM_QUEUE_COMPARISON_SPSC) {
+        tm_spsc_ring_init(&tm_queue_comparison_ring, storage, TM_QUEUE_COMPARISON_DEPTH, bytes);
+    } else if (kind == TM_QUEUE_COMPARISON_MQ) {
+        if (rt_mq_init(&tm_queue_comparison_mq, "tm_cmp", storage, bytes, storage_size, RT_IPC_FLAG_FIFO) != RT_EOK) {
+            rt_free_align(storage);
+            return;
+        }
+    } else {
+#if defined(RT_USING_DEVICE_IPC)
+        rt_ringbuffer_init(&tm_queue_comparison_rb, (rt_uint8_t *)storage, (rt_int16_t)storage_size);
+#endif
+    }
+
+    /* Create the producer and the consumer at priority 10, on the same core or on two.  */
+    tm_queue_comparison_kind = kind;
+    tm_queue_comparison_bytes = bytes;
+    tm_queue_comparison_corrupted = 0;
+    tm_thread_create(0, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_queue_comparison_thread_0_entry);
+    tm_thread_create(1, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_queue_comparison_thread_1_entry);
+    tm_thread_bind(0, 0);
+    tm_thread_bind(1, placement);
+    tm_thread_resume(1);
+    tm_thread_resume(0);
+
+    /* Measure the messages received for one period, then stop the threads.  */
+    tm_queue_comparison_ops[placement][size][kind] =
+        tm_measure(TM_QUEUE_COMPARISON_ID, tm_queue_comparison_counter_read);
+    tm_queue_comparison_cost[placement][size][kind] = tm_measure_cost(TM_QUEUE_COMPARISON_ID);
+    tm_thread_detach_wait();
+    status = ((tm_queue_comparison_ops[placement][size][kind] != 0) && !tm_queue_comparison_corrupted) ?
+             TM_SUCCESS : TM_ERROR;
+    tm_queue_comparison_status[placement][size][kind] = status;
+    if (kind == TM_QUEUE_COMPARISON_MQ) {
+        rt_mq_detach(&tm_queue_comparison_mq);
+    }
+    rt_free_align(storage);
+}
+
+/* Define the queue comparison test initialization.  */
+
+void tm_queue_comparison_initialize(void)
+{
+    int placement;
+    int size;
+    int kind;
+
+    /* Run the threads on two cores only if there are.  */
+    tm_queue_comparison_placements = (tm_cpu_count() > 1) ? TM_QUEUE_COMPARISON_PLACEMENTS : 1;
+
+    for (placement = 0; placement < tm_queue_comparison_placements; placement++) {
+        for (size = 0; size < TM_QUEUE_COMPARISON_SIZES; size++) {
+            for (kind = 0; kind < TM_QUEUE_COMPARISON_KINDS; kind++) {
+                tm_queue_comparison_variant(placement, size, kind);
+            }
+        }
+    }
+
+    tm_queue_comparison_thread_report();
+}
+
+/* Define the queue comparison reporting function.  */
+void tm_queue_comparison_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long ops;
+    unsigned long mq_ops;
+    char label[48];
+    char cost_buffer[16];
+    char ratio_buffer[16];
+    int variants;
+    int failed;
+    int placement;
+    int size;
+    int kind;
+
+    /* Total the messages of all variants.  */
+    period_counter = 0;
+    variants = 0;
+    failed = 0;
+    for (placement = 0; placement < tm_queue_comparison_placements; placement++) {
+        for (size = 0; size < TM_QUEUE_COMPARISON_SIZES; size++) {
+            for (kind = 0; kind < TM_QUEUE_COMPARISON_KINDS; kind++) {
+#if !defined(RT_USING_DEVICE_IPC)
+                if (kind == TM_QUEUE_COMPARISON_RINGBUFFER) {
+                    continue;
+                }
+#endif
+                period_counter += tm_queue_comparison_ops[placement][size][kind];
+                failed |= (tm_queue_comparison_status[placement][size][kind] != TM_SUCCESS);
+                variants++;
+            }
+        }
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Queue comparison thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_QUEUE_COMPARISON_ID, "message lost, reordered or torn");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Queue Comparison Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)variants, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  cores, bytes, queue", "messages", "counts/msg", "vs mq");
+    for (placement = 0; placement < tm_queue_comparison_placements; placement++) {
+        for (size = 0; size < TM_QUEUE_COMPARISON_SIZES; size++) {
+            mq_ops = tm_queue_comparison_ops[placement][size][TM_QUEUE_COMPARISON_MQ];
+            for (kind = 0; kind < TM_QUEUE_COMPARISON_KINDS; kind++) {
+#if !defined(RT_USING_DEVICE_IPC)
+                if (kind == TM_QUEUE_COMPARISON_RINGBUFFER) {
+                    continue;
+                }
+#endif
+                ops = tm_queue_comparison_ops[placement][size][kind];
+                snprintf(label, sizeof(label), "%s, %lu, %s", tm_queue_comparison_placement_name[placement],
+                         tm_queue_comparison_size[size], tm_queue_comparison_kind_name[kind]);
+                printf("|   %-38s | %-10lu | %-10s | %-10s |\n", label, ops,
+                       (tm_queue_comparison_status[placement][size][kind] == TM_SUCCESS) ?
+                       tm_measure_format(cost_buffer, sizeof(cost_buffer), tm_queue_comparison_cost[placement][size][kind]) :
+                       "FAILED",
+                       (mq_ops != 0) ?
+                       tm_measure_format(ratio_buffer, sizeof(ratio_buffer), (unsigned long long)ops * 100 / mq_ops) :
+                       "-");
+            }
+        }
+    }
+    tm_measure_report(TM_QUEUE_COMPARISON_ID);
+
+    tm_teardown();
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+#include "tm_reference.h"
+
+/*
+ * Initialize an empty ring over the specified buffer of slots * slot_size
+ * bytes. The number of slots must be a power of two.
+ */
+void tm_spsc_ring_init(tm_spsc_ring_t *ring, void *buffer, unsigned long slots, unsigned long slot_size)
+{
+    RT_ASSERT((slots != 0) && ((slots & (slots - 1)) == 0));
+
+    ring->buffer = (unsigned char *)buffer;
+    ring->slot_size = slot_size;
+    ring->slots = slots;
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+}
+
+/*
+ * Initialize a pool with as many blocks of block_size bytes as the specified
+ * storage holds, see TM_POOL_STORAGE_SIZE(). The storage must be aligned to
+ * a word, and there may be at most TM_POOL_INDEX_MASK blocks.
+ */
+void tm_lockfree_pool_init(tm_lockfree_pool_t *pool, void *storage, unsigned long storage_size,
+                           unsigned long block_size)
+{
+    unsigned long i;
+
+    pool->blocks = (unsigned char *)storage;
+    pool->stride = sizeof(atomic_ulong) + RT_ALIGN(block_size, sizeof(atomic_ulong));
+    pool->count = storage_size / pool->stride;
+    RT_ASSERT(pool->count <= TM_POOL_INDEX_MASK);
+
+    /* Chain all blocks in order, the link of the last one is 0 for none.  */
+    for (i = 0; i < pool->count; i++)
+    {
+        atomic_init(tm_lockfree_pool_link(pool, i), (i + 1 < pool->count) ? i + 2 : 0);
+    }
+    atomic_init(&pool->head, (pool->count != 0) ? 1 : 0);
+}
+
+/* Disable the interrupts of the current core and return its cache.  */
+static tm_pool_cache_t *tm_percpu_pool_lock(tm_percpu_pool_t *pool, rt_base_t *level)
+{
+#ifdef RT_USING_SMP
+    *level = rt_hw_local_irq_disable();
+    return &pool->cache[rt_hw_cpu_id()];
+#else
+    *level = rt_hw_interrupt_disable();
+    return &pool->cache[0];
+#endif
+}
+
+static void tm_percpu_pool_unlock(rt_base_t level)
+{
+#ifdef RT_USING_SMP
+    rt_hw_local_irq_enable(level);
+#else
+    rt_hw_interrupt_enable(level);
+#endif
+}
+
+/* Initialize a per-core pool over the specified storage, see tm_lockfree_pool_init().  */
+void tm_percpu_pool_init(tm_percpu_pool_t *pool, void *storage, unsigned long storage_size,
+                         unsigned long block_size)
+{
+    int i;
+
+    tm_lockfree_pool_init(&pool->shared, storage, storage_size, block_size);
+    for (i = 0; i < TM_POOL_CPUS; i++)
+    {
+        pool->cache[i].count = 0;
+    }
+}
+
+/*
+ * Allocate a block from the cache of the current core, refilling it from
+ * the shared pool if it is empty.
+ * Returns the block, RT_NULL if the cache and the shared pool are empty.
+ */
+void *tm_percpu_pool_alloc(tm_percpu_pool_t *pool)
+{
+    tm_pool_cache_t *cache;
+    rt_base_t level;
+    void *block;
+
+    cache = tm_percpu_pool_lock(pool, &level);
+    while (cache->count < TM_POOL_CACHE_BLOCKS / 2)
+    {
+        block = tm_lockfree_pool_alloc(&pool->shared);
+        if (block == RT_NULL)
+        {
+            break;
+        }
+        cache->block[cache->count++] = block;
+    }
+    block = (cache->count != 0) ? cache->block[--cache->count] : RT_NULL;
+    tm_percpu_pool_unlock(level);
+
+    return block;
+}
+
+/* Return a block to the cache of the current core, moving half of a full cache to the shared pool.  */
+void tm_percpu_pool_free(tm_percpu_pool_t *pool, void *block)
+{
+    tm_pool_cache_t *cache;
+    rt_base_t level;
+
+    cache = tm_percpu_pool_lock(pool, &level);
+    if (cache->count == TM_POOL_CACHE_BLOCKS)
+    {
+        while (cache->count > TM_POOL_CACHE_BLOCKS / 2)
+        {
+            tm_lockfree_pool_free(&pool->shared, cache->block[--cache->count]);
+        }
+    }
+    cache->block[cache->count++] = block;
+    tm_percpu_pool_unlock(level);
+}
+
+/*
+ * Initialize a semaphore with the specified number of units.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+int tm_fast_sem_init(tm_fast_sem_t *sem, const char *name, long value)
+{
+    atomic_init(&sem->count, value);
+    return (rt_sem_init(&sem->wait, name, 0, RT_IPC_FLAG_PRIO) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/* Detach a semaphore that no thread is waiting on.  */
+void tm_fast_sem_detach(tm_fast_sem_t *sem)
+{
+    rt_sem_detach(&sem->wait);
+}
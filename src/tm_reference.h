@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Reference implementations of kernel services, built on C11 atomics. The
+ * comparison tests run them side by side with the RT-Thread services they
+ * stand in for.
+ */
+
+#ifndef TM_REFERENCE_H
+#define TM_REFERENCE_H
+
+#include <stdatomic.h>
+#include <string.h>
+#include "tm_api.h"
+
+/*
+ * Define a lock-free single-producer/single-consumer ring of fixed size
+ * slots. The head is written only by the producer and the tail only by the
+ * consumer; each is kept on its own cache line together with the owner's
+ * cached copy of the other index, so that the two sides only exchange cache
+ * lines when the ring looks full or empty.
+ */
+typedef struct tm_spsc_ring
+{
+    /* Written by the producer.  */
+    rt_align(TM_CACHE_LINE_SIZE) atomic_ulong head;
+    unsigned long tail_cache;
+
+    /* Written by the consumer.  */
+    rt_align(TM_CACHE_LINE_SIZE) atomic_ulong tail;
+    unsigned long head_cache;
+
+    /* Constant after initialization.  */
+    rt_align(TM_CACHE_LINE_SIZE) unsigned char *buffer;
+    unsigned long slot_size;
+    unsigned long slots;
+} tm_spsc_ring_t;
+
+void tm_spsc_ring_init(tm_spsc_ring_t *ring, void *buffer, unsigned long slots, unsigned long slot_size);
+
+/*
+ * Copy a message into the ring. Must only be called by the producer.
+ * Returns TM_SUCCESS on success, TM_ERROR if the ring is full.
+ */
+rt_inline int tm_spsc_ring_put(tm_spsc_ring_t *ring, const void *message)
+{
+    unsigned long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    if (head - ring->tail_cache == ring->slots)
+    {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->tail_cache == ring->slots)
+        {
+            return TM_ERROR;
+        }
+    }
+
+    memcpy(&ring->buffer[(head & (ring->slots - 1)) * ring->slot_size], message, ring->slot_size);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return TM_SUCCESS;
+}
+
+/*
+ * Copy the oldest message out of the ring. Must only be called by the consumer.
+ * Returns TM_SUCCESS on success, TM_ERROR if the ring is empty.
+ */
+rt_inline int tm_spsc_ring_get(tm_spsc_ring_t *ring, void *message)
+{
+    unsigned long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail == ring->head_cache)
+    {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail == ring->head_cache)
+        {
+            return TM_ERROR;
+        }
+    }
+
+    memcpy(message, &ring->buffer[(tail & (ring->slots - 1)) * ring->slot_size], ring->slot_size);
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return TM_SUCCESS;
+}
+
+/*
+ * Define a lock-free pool of fixed size blocks, kept as a Treiber stack.
+ * Like rt_mempool each block is preceded by a header word, here holding the
+ * index of the next free block. The head packs the index of the first free
+ * block plus one in its low half and a tag in its high half. The tag is
+ * advanced by every change, so that a compare-exchange fails if the head was
+ * popped and pushed back in between (ABA), with single word atomics only.
+ */
+#define TM_POOL_INDEX_BITS (sizeof(unsigned long) * 4)
+#define TM_POOL_INDEX_MASK ((1UL << TM_POOL_INDEX_BITS) - 1)
+#define TM_POOL_TAG_ONE    (1UL << TM_POOL_INDEX_BITS)
+
+typedef struct tm_lockfree_pool
+{
+    /* Written by every allocation and free.  */
+    rt_align(TM_CACHE_LINE_SIZE) atomic_ulong head;
+
+    /* Constant after initialization.  */
+    rt_align(TM_CACHE_LINE_SIZE) unsigned char *blocks;
+    unsigned long stride;
+    unsigned long count;
+} tm_lockfree_pool_t;
+
+/* Define the storage needed for the specified number of blocks, as for rt_mp_init().  */
+#define TM_POOL_STORAGE_SIZE(blocks, block_size) \
+    ((blocks) * (sizeof(atomic_ulong) + RT_ALIGN((block_size), sizeof(atomic_ulong))))
+
+void tm_lockfree_pool_init(tm_lockfree_pool_t *pool, void *storage, unsigned long storage_size,
+                           unsigned long block_size);
+
+/* Return the header of the block of the specified index.  */
+rt_inline atomic_ulong *tm_lockfree_pool_link(tm_lockfree_pool_t *pool, unsigned long index)
+{
+    return (atomic_ulong *)&pool->blocks[index * pool->stride];
+}
+
+/*
+ * Allocate a block from the pool without waiting.
+ * Returns the block, RT_NULL if the pool is empty.
+ */
+rt_inline void *tm_lockfree_pool_alloc(tm_lockfree_pool_t *pool)
+{
+    unsigned long head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    unsigned long next;
+    unsigned long index;
+
+    do
+    {
+        index = head & TM_POOL_INDEX_MASK;
+        if (index == 0)
+        {
+            return RT_NULL;
+        }
+
+        /* The link may be stale if the block was taken meanwhile, the tag then fails the exchange.  */
+        next = atomic_load_explicit(tm_lockfree_pool_link(pool, index - 1), memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head,
+                                                    ((head & ~TM_POOL_INDEX_MASK) + TM_POOL_TAG_ONE) | next,
+                                                    memory_order_acquire, memory_order_acquire));
+
+    return tm_lockfree_pool_link(pool, index - 1) + 1;
+}
+
+/* Return a block allocated by tm_lockfree_pool_alloc() to the pool.  */
+rt_inline void tm_lockfree_pool_free(tm_lockfree_pool_t *pool, void *block)
+{
+    atomic_ulong *link = (atomic_ulong *)block - 1;
+    unsigned long index = ((unsigned char *)link - pool->blocks) / pool->stride;
+    unsigned long head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+
+    do
+    {
+        atomic_store_explicit(link, head & TM_POOL_INDEX_MASK, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->head, &head,
+                                                    ((head & ~TM_POOL_INDEX_MASK) + TM_POOL_TAG_ONE) | (index + 1),
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/*
+ * Define a pool with a small cache of free blocks per core in front of a
+ * lock-free pool. A core allocates from and frees to its own cache with only
+ * its local interrupts disabled, and moves half a cache of blocks from or
+ * to the shared pool when its cache runs empty or full.
+ */
+#ifdef RT_USING_SMP
+#define TM_POOL_CPUS RT_CPUS_NR
+#else
+#define TM_POOL_CPUS 1
+#endif
+
+#define TM_POOL_CACHE_BLOCKS 8
+
+typedef struct tm_pool_cache
+{
+    rt_align(TM_CACHE_LINE_SIZE) unsigned long count;
+    void *block[TM_POOL_CACHE_BLOCKS];
+} tm_pool_cache_t;
+
+typedef struct tm_percpu_pool
+{
+    tm_lockfree_pool_t shared;
+    tm_pool_cache_t cache[TM_POOL_CPUS];
+} tm_percpu_pool_t;
+
+void tm_percpu_pool_init(tm_percpu_pool_t *pool, void *storage, unsigned long storage_size,
+                         unsigned long block_size);
+void *tm_percpu_pool_alloc(tm_percpu_pool_t *pool);
+void tm_percpu_pool_free(tm_percpu_pool_t *pool, void *block);
+
+/*
+ * Define a semaphore with an atomic fast path. The count holds the units
+ * available or, when negative, the number of threads waiting. Take and
+ * release only update the count while there is no waiter, and fall back to
+ * an rt_semaphore, which counts the wakeups, to block and wake threads.
+ */
+typedef struct tm_fast_sem
+{
+    rt_align(TM_CACHE_LINE_SIZE) atomic_long count;
+    struct rt_semaphore wait;
+} tm_fast_sem_t;
+
+int tm_fast_sem_init(tm_fast_sem_t *sem, const char *name, long value);
+void tm_fast_sem_detach(tm_fast_sem_t *sem);
+
+/*
+ * Take a unit of the semaphore, waiting for it if there is none.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+rt_inline int tm_fast_sem_take(tm_fast_sem_t *sem)
+{
+    if (atomic_fetch_sub_explicit(&sem->count, 1, memory_order_acquire) > 0)
+    {
+        return TM_SUCCESS;
+    }
+
+    return (rt_sem_take(&sem->wait, RT_WAITING_FOREVER) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * Release a unit of the semaphore, waking a waiting thread if there is one.
+ * Returns TM_SUCCESS on success, TM_ERROR on failure.
+ */
+rt_inline int tm_fast_sem_release(tm_fast_sem_t *sem)
+{
+    if (atomic_fetch_add_explicit(&sem->count, 1, memory_order_release) >= 0)
+    {
+        return TM_SUCCESS;
+    }
+
+    return (rt_sem_release(&sem->wait) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Semaphore comparison test. Runs the get/put loop of the synchronization
+ * processing test on a binary rt_semaphore and on the fast semaphore of
+ * tm_reference.h, in three scenarios: one thread, as in the synchronization
+ * test; two threads on one core, each holding the semaphore across a yield
+ * so that every get blocks; and on SMP builds with two cores or more one
+ * thread per core, all contending for the semaphore. Each scenario and
+ * semaphore runs for one test period. The threads check that at most one of
+ * them holds the semaphore at a time.
+ */
+
+#include "tm_api.h"
+#include "tm_reference.h"
+
+/* Define the semaphores and the scenarios compared.  */
+#define TM_SEMAPHORE_COMPARISON_RT_SEM     0
+#define TM_SEMAPHORE_COMPARISON_FAST_SEM   1
+#define TM_SEMAPHORE_COMPARISON_KINDS      2
+
+#define TM_SEMAPHORE_COMPARISON_UNCONTENDED 0
+#define TM_SEMAPHORE_COMPARISON_HANDOFF     1
+#define TM_SEMAPHORE_COMPARISON_CORES       2
+#define TM_SEMAPHORE_COMPARISON_SCENARIOS   3
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_SEMAPHORE_COMPARISON_MAX_THREADS 8
+
+static const char *tm_semaphore_comparison_kind_name[TM_SEMAPHORE_COMPARISON_KINDS] = {
+    "rt_sem",
+    "fast sem",
+};
+
+static const char *tm_semaphore_comparison_scenario_name[TM_SEMAPHORE_COMPARISON_SCENARIOS] = {
+    "uncontended",
+    "handoff, 1 core",
+    "all cores",
+};
+
+TM_COUNTER tm_semaphore_comparison_counter[TM_SEMAPHORE_COMPARISON_MAX_THREADS];
+
+/* Define the semaphores, only the one of the current variant is initialized.  */
+
+static struct rt_semaphore tm_semaphore_comparison_rt_sem;
+static tm_fast_sem_t tm_semaphore_comparison_fast_sem;
+
+/* Define the semaphore, the scenario and the number of threads of the current variant.  */
+
+static volatile int tm_semaphore_comparison_kind;
+static volatile int tm_semaphore_comparison_scenario;
+static int tm_semaphore_comparison_threads;
+
+/* Define the number of threads holding the semaphore, and whether it was ever more than one.  */
+static volatile int tm_semaphore_comparison_holders;
+static volatile int tm_semaphore_comparison_corrupted;
+
+/* Define the results of each variant.  */
+static unsigned long tm_semaphore_comparison_ops[TM_SEMAPHORE_COMPARISON_SCENARIOS][TM_SEMAPHORE_COMPARISON_KINDS];
+static int tm_semaphore_comparison_status[TM_SEMAPHORE_COMPARISON_SCENARIOS][TM_SEMAPHORE_COMPARISON_KINDS];
+static int tm_semaphore_comparison_scenario_threads[TM_SEMAPHORE_COMPARISON_SCENARIOS];
+
+/* Define the test thread prototypes.  */
+
+void tm_semaphore_comparison_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_semaphore_comparison_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_semaphore_comparison_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_semaphore_comparison_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_semaphore_comparison_initialize);
+
+    return 0;
+}
+
+/* Define the semaphore comparison thread.  */
+void tm_semaphore_comparison_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    int kind = tm_semaphore_comparison_kind;
+    int handoff = (tm_semaphore_comparison_scenario == TM_SEMAPHORE_COMPARISON_HANDOFF);
+    int status;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Get the semaphore.  */
+        if (kind == TM_SEMAPHORE_COMPARISON_RT_SEM) {
+            status = (rt_sem_take(&tm_semaphore_comparison_rt_sem, RT_WAITING_FOREVER) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+        } else {
+            status = tm_fast_sem_take(&tm_semaphore_comparison_fast_sem);
+        }
+        if (status != TM_SUCCESS) {
+            break;
+        }
+
+        /* Check that no other thread holds it.  */
+        if (tm_semaphore_comparison_holders++ != 0) {
+            tm_semaphore_comparison_corrupted = 1;
+        }
+
+        /* Let the other thread on the core run into the semaphore.  */
+        if (handoff) {
+            tm_thread_relinquish();
+        }
+
+        tm_semaphore_comparison_holders--;
+
+        /* Release the semaphore.  */
+        if (kind == TM_SEMAPHORE_COMPARISON_RT_SEM) {
+            status = (rt_sem_release(&tm_semaphore_comparison_rt_sem) == RT_EOK) ? TM_SUCCESS : TM_ERROR;
+        } else {
+            status = tm_fast_sem_release(&tm_semaphore_comparison_fast_sem);
+        }
+        if (status != TM_SUCCESS) {
+            break;
+        }
+
+        /* Increment the number of semaphore get/puts of the thread.  */
+        tm_counter_increment(&tm_semaphore_comparison_counter[id]);
+    }
+}
+
+/* Define the semaphore comparison counter read function, the total of all threads.  */
+static unsigned long long tm_semaphore_comparison_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_semaphore_comparison_threads; i++) {
+        total += tm_counter_read(&tm_semaphore_comparison_counter[i]);
+    }
+
+    return total;
+}
+
+/* Measure one semaphore in one scenario with the specified number of threads.  */
+static void tm_semaphore_comparison_variant(int scenario, int kind, int threads)
+{
+    int status;
+    int i;
+
+    tm_semaphore_comparison_status[scenario][kind] = TM_ERROR;
+
+    /* Initialize the semaphore with one unit.  */
+    if (kind == TM_SEMAPHORE_COMPARISON_RT_SEM) {
+        status = (rt_sem_init(&tm_semaphore_comparison_rt_sem, "tm_cmp", 1, RT_IPC_FLAG_PRIO) == RT_EOK) ?
+                 TM_SUCCESS : TM_ERROR;
+    } else {
+        status = tm_fast_sem_init(&tm_semaphore_comparison_fast_sem, "tm_cmp", 1);
+    }
+    if (status != TM_SUCCESS) {
+        return;
+    }
+
+    /* Create the threads at priority 10, bound to core 0 or one per core.  */
+    tm_semaphore_comparison_kind = kind;
+    tm_semaphore_comparison_scenario = scenario;
+    tm_semaphore_comparison_threads = threads;
+    tm_semaphore_comparison_holders = 0;
+    tm_semaphore_comparison_corrupted = 0;
+    for (i = 0; i < threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_semaphore_comparison_thread_entry);
+        tm_thread_bind(i, (scenario == TM_SEMAPHORE_COMPARISON_CORES) ? i : 0);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_resume(i);
+    }
+
+    /* Measure the total for one period, then stop the threads.  */
+    tm_semaphore_comparison_ops[scenario][kind] =
+        tm_measure(TM_SEMAPHORE_COMPARISON_ID, tm_semaphore_comparison_counter_read);
+    tm_thread_detach_wait();
+    tm_semaphore_comparison_status[scenario][kind] =
+        ((tm_semaphore_comparison_ops[scenario][kind] != 0) && !tm_semaphore_comparison_corrupted) ?
+        TM_SUCCESS : TM_ERROR;
+    if (kind == TM_SEMAPHORE_COMPARISON_RT_SEM) {
+        rt_sem_detach(&tm_semaphore_comparison_rt_sem);
+    } else {
+        tm_fast_sem_detach(&tm_semaphore_comparison_fast_sem);
+    }
+}
+
+/* Define the semaphore comparison test initialization.  */
+
+void tm_semaphore_comparison_initialize(void)
+{
+    int cores = tm_cpu_count();
+    int scenario;
+    int kind;
+
+    if (cores > TM_SEMAPHORE_COMPARISON_MAX_THREADS) {
+        cores = TM_SEMAPHORE_COMPARISON_MAX_THREADS;
+    }
+
+    /* Run the threads on all cores only if there are two or more.  */
+    tm_semaphore_comparison_scenario_threads[TM_SEMAPHORE_COMPARISON_UNCONTENDED] = 1;
+    tm_semaphore_comparison_scenario_threads[TM_SEMAPHORE_COMPARISON_HANDOFF] = 2;
+    tm_semaphore_comparison_scenario_threads[TM_SEMAPHORE_COMPARISON_CORES] = (cores > 1) ? cores : 0;
+
+    for (scenario = 0; scenario < TM_SEMAPHORE_COMPARISON_SCENARIOS; scenario++) {
+        for (kind = 0; (kind < TM_SEMAPHORE_COMPARISON_KINDS) && tm_semaphore_comparison_scenario_threads[scenario]; kind++) {
+            tm_semaphore_comparison_variant(scenario, kind, tm_semaphore_comparison_scenario_threads[scenario]);
+        }
+    }
+
+    tm_semaphore_comparison_thread_report();
+}
+
+/* Define the semaphore comparison reporting function.  */
+void tm_semaphore_comparison_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long ops;
+    unsigned long base;
+    char label[48];
+    char buffer[16];
+    int variants;
+    int failed;
+    int scenario;
+    int kind;
+
+    /* Total the get/puts of all variants.  */
+    period_counter = 0;
+    variants = 0;
+    failed = 0;
+    for (scenario = 0; scenario < TM_SEMAPHORE_COMPARISON_SCENARIOS; scenario++) {
+        for (kind = 0; (kind < TM_SEMAPHORE_COMPARISON_KINDS) && tm_semaphore_comparison_scenario_threads[scenario]; kind++) {
+            period_counter += tm_semaphore_comparison_ops[scenario][kind];
+            failed |= (tm_semaphore_comparison_status[scenario][kind] != TM_SUCCESS);
+            variants++;
+        }
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Error getting/putting semaphore!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_SEMAPHORE_COMPARISON_ID, "semaphore held by two threads");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Semaphore Comparison Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)variants, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  scenario, semaphore", "threads", "period", "vs rt_sem");
+    for (scenario = 0; scenario < TM_SEMAPHORE_COMPARISON_SCENARIOS; scenario++) {
+        for (kind = 0; (kind < TM_SEMAPHORE_COMPARISON_KINDS) && tm_semaphore_comparison_scenario_threads[scenario]; kind++) {
+            ops = tm_semaphore_comparison_ops[scenario][kind];
+            base = tm_semaphore_comparison_ops[scenario][TM_SEMAPHORE_COMPARISON_RT_SEM];
+            snprintf(label, sizeof(label), "%s, %s", tm_semaphore_comparison_scenario_name[scenario],
+                     tm_semaphore_comparison_kind_name[kind]);
+            printf("|   %-38s | %-10d | %-10lu | %-10s |\n", label, tm_semaphore_comparison_scenario_threads[scenario], ops,
+                   (tm_semaphore_comparison_status[scenario][kind] != TM_SUCCESS) ? "FAILED" : ((base == 0) ? "-" :
+                   tm_measure_format(buffer, sizeof(buffer), (unsigned long long)ops * 100 / base)));
+        }
+    }
+    tm_measure_report(TM_SEMAPHORE_COMPARISON_ID);
+
+    tm_teardown();
+}
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Spinlock test. First measures one thread entering and leaving a short
+ * critical section with rt_spin_lock, rt_spin_lock_irqsave,
+ * rt_enter_critical and rt_hw_interrupt_disable. Then, on SMP builds, runs
+ * one thread per core on 2 to N cores, all taking the same rt_spin_lock.
+ * Each variant runs for one test period. Under contention the holder
+ * timestamps its release and the next holder, if it runs on another core,
+ * the acquire; their difference is the handoff latency. The fairness is
+ * Jain's index of the acquisitions of the threads, 100% when all threads
+ * took the lock equally often. Every critical section increments a plain
+ * counter, which is checked against the acquisitions counted. The handoff
+ * latency compares timestamps taken on two cores, so the timestamp counter
+ * must be common to all cores, as the generic timer of QEMU virt is.
+ */
+
+#include "tm_api.h"
+
+#define TM_SPINLOCK_BATCH 16
+
+/* Define the maximum number of cores used, at most the number of test threads.  */
+#define TM_SPINLOCK_MAX_THREADS 8
+
+TM_COUNTER tm_spinlock_counter[TM_SPINLOCK_MAX_THREADS];
+
+/* Define the lock and the data it protects.  */
+
+static struct rt_spinlock tm_spinlock_lock;
+static volatile unsigned long tm_spinlock_protected;
+static volatile int tm_spinlock_owner;
+static volatile unsigned long long tm_spinlock_released;
+
+/* Define the handoff statistics, updated under the lock.  */
+
+static unsigned long long tm_spinlock_handoff_total;
+static unsigned long long tm_spinlock_handoff_max;
+static unsigned long tm_spinlock_handoffs;
+
+/* Set to make the threads leave their loop and suspend, so that none is deleted while it holds the lock.  */
+static volatile int tm_spinlock_stop;
+
+/* Define the critical sections measured without contention, each runs a batch.  */
+
+static void tm_spinlock_spin(void)
+{
+    int i;
+
+    for (i = 0; i < TM_SPINLOCK_BATCH; i++) {
+        rt_spin_lock(&tm_spinlock_lock);
+        tm_spinlock_protected++;
+        rt_spin_unlock(&tm_spinlock_lock);
+    }
+}
+
+static void tm_spinlock_spin_irqsave(void)
+{
+    rt_base_t level;
+    int i;
+
+    for (i = 0; i < TM_SPINLOCK_BATCH; i++) {
+        level = rt_spin_lock_irqsave(&tm_spinlock_lock);
+        tm_spinlock_protected++;
+        rt_spin_unlock_irqrestore(&tm_spinlock_lock, level);
+    }
+}
+
+static void tm_spinlock_critical(void)
+{
+    int i;
+
+    for (i = 0; i < TM_SPINLOCK_BATCH; i++) {
+        rt_enter_critical();
+        tm_spinlock_protected++;
+        rt_exit_critical();
+    }
+}
+
+static void tm_spinlock_interrupt_disable(void)
+{
+    rt_base_t level;
+    int i;
+
+    for (i = 0; i < TM_SPINLOCK_BATCH; i++) {
+        level = rt_hw_interrupt_disable();
+        tm_spinlock_protected++;
+        rt_hw_interrupt_enable(level);
+    }
+}
+
+typedef struct tm_spinlock_primitive {
+    const char *name;
+    void (*run)(void);
+} tm_spinlock_primitive_t;
+
+static const tm_spinlock_primitive_t tm_spinlock_primitive[] = {
+    { "rt_spin_lock",            tm_spinlock_spin },
+    { "rt_spin_lock_irqsave",    tm_spinlock_spin_irqsave },
+    { "rt_enter_critical",       tm_spinlock_critical },
+    { "rt_hw_interrupt_disable", tm_spinlock_interrupt_disable },
+};
+
+#define TM_SPINLOCK_PRIMITIVE_NUM (sizeof(tm_spinlock_primitive) / sizeof(tm_spinlock_primitive[0]))
+
+/* Define the primitive measured without contention and the number of threads of the current variant.  */
+
+static const tm_spinlock_primitive_t *volatile tm_spinlock_current;
+static int tm_spinlock_threads;
+
+/* Define the results of the uncontended variants.  */
+static unsigned long tm_spinlock_primitive_ops[TM_SPINLOCK_PRIMITIVE_NUM];
+static unsigned long long tm_spinlock_primitive_cost[TM_SPINLOCK_PRIMITIVE_NUM];
+static int tm_spinlock_primitive_status[TM_SPINLOCK_PRIMITIVE_NUM];
+
+/* Define the results of the contended variants, indexed by the number of cores.  */
+static unsigned long tm_spinlock_contended_ops[TM_SPINLOCK_MAX_THREADS + 1];
+static unsigned long long tm_spinlock_contended_handoff[TM_SPINLOCK_MAX_THREADS + 1];
+static unsigned long long tm_spinlock_contended_handoff_max[TM_SPINLOCK_MAX_THREADS + 1];
+static unsigned long tm_spinlock_contended_fairness[TM_SPINLOCK_MAX_THREADS + 1];
+static int tm_spinlock_contended_status[TM_SPINLOCK_MAX_THREADS + 1];
+static int tm_spinlock_cores;
+
+/* Define the reason the first failed variant failed.  */
+static const char *tm_spinlock_reason;
+
+/* Define the test thread prototypes.  */
+
+void tm_spinlock_uncontended_thread_entry(void *p1, void *p2, void *p3);
+void tm_spinlock_contended_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_spinlock_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_spinlock_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_spinlock_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_spinlock_initialize);
+
+    return 0;
+}
+
+/* Define the thread measuring a primitive without contention.  */
+void tm_spinlock_uncontended_thread_entry(void *p1, void *p2, void *p3)
+{
+    const tm_spinlock_primitive_t *primitive = tm_spinlock_current;
+
+    (void)p1;
+    (void)p2;
+    (void)p3;
+
+    while (!tm_spinlock_stop) {
+
+        /* Run a batch of critical sections.  */
+        primitive->run();
+
+        /* Increment the number of batches.  */
+        tm_counter_increment(&tm_spinlock_counter[0]);
+    }
+
+    while (1) {
+        tm_thread_suspend(0);
+    }
+}
+
+/* Define the contending threads, one per core.  */
+void tm_spinlock_contended_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    unsigned long long now;
+    unsigned long long latency;
+
+    (void)p2;
+    (void)p3;
+
+    while (!tm_spinlock_stop) {
+
+        rt_spin_lock(&tm_spinlock_lock);
+
+        /* Account the handoff if the lock comes from another core.  */
+        now = tm_timestamp_get();
+        if ((tm_spinlock_owner >= 0) && (tm_spinlock_owner != id)) {
+            latency = now - tm_spinlock_released;
+            tm_spinlock_handoff_total += latency;
+            tm_spinlock_handoffs++;
+            if (latency > tm_spinlock_handoff_max) {
+                tm_spinlock_handoff_max = latency;
+            }
+        }
+        tm_spinlock_protected++;
+        tm_spinlock_owner = id;
+        tm_spinlock_released = tm_timestamp_get();
+
+        rt_spin_unlock(&tm_spinlock_lock);
+
+        /* Increment the number of acquisitions of the thread.  */
+        tm_counter_increment(&tm_spinlock_counter[id]);
+    }
+
+    while (1) {
+        tm_thread_suspend(id);
+    }
+}
+
+/* Define the spinlock counter read function, the total of all threads.  */
+static unsigned long long tm_spinlock_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_spinlock_threads; i++) {
+        total += tm_counter_read(&tm_spinlock_counter[i]);
+    }
+
+    return total;
+}
+
+/*
+ * Start the specified number of threads at priority 10, bound to their
+ * cores, and return the counts of their counters.
+ */
+static void tm_spinlock_start(int threads, void (*entry_function)(void *, void *, void *), unsigned long long *start)
+{
+    int i;
+
+    rt_spin_lock_init(&tm_spinlock_lock);
+    tm_spinlock_protected = 0;
+    tm_spinlock_owner = -1;
+    tm_spinlock_handoff_total = 0;
+    tm_spinlock_handoff_max = 0;
+    tm_spinlock_handoffs = 0;
+    tm_spinlock_stop = 0;
+    tm_spinlock_threads = threads;
+
+    for (i = 0; i < threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, entry_function);
+        tm_thread_bind(i, i);
+        start[i] = tm_counter_read(&tm_spinlock_counter[i]);
+    }
+    for (i = 0; i < threads; i++) {
+        tm_thread_resume(i);
+    }
+}
+
+/*
+ * Stop the threads, then check the protected counter against the counts.
+ * Returns TM_SUCCESS if no increment was lost, TM_ERROR otherwise.
+ */
+static int tm_spinlock_stop_threads(int threads, unsigned long long *start, unsigned long per_count)
+{
+    unsigned long long total = 0;
+    int i;
+
+    /* Let the threads leave their critical sections before they are deleted.  */
+    tm_spinlock_stop = 1;
+    tm_thread_sleep_ms(10);
+
+    for (i = 0; i < threads; i++) {
+        total += tm_counter_read(&tm_spinlock_counter[i]) - start[i];
+    }
+    tm_thread_detach();
+
+    return (((unsigned long long)tm_spinlock_protected >= total * per_count) &&
+            ((unsigned long long)tm_spinlock_protected <= (total + threads) * per_count)) ? TM_SUCCESS : TM_ERROR;
+}
+
+/*
+ * Return the status of a variant from its count check and its number of
+ * operations, and keep the reason if it is the first to fail.
+ */
+static int tm_spinlock_status(int check, unsigned long ops)
+{
+    const char *reason = RT_NULL;
+
+    if (check != TM_SUCCESS) {
+        reason = "critical section entered twice";
+    } else if (ops == 0) {
+        reason = "a variant made no progress";
+    }
+    if ((reason != RT_NULL) && (tm_spinlock_reason == RT_NULL)) {
+        tm_spinlock_reason = reason;
+    }
+
+    return (reason == RT_NULL) ? TM_SUCCESS : TM_ERROR;
+}
+
+/* Measure a primitive in one thread without contention.  */
+static void tm_spinlock_uncontended(unsigned int index)
+{
+    unsigned long long start[1];
+
+    tm_spinlock_current = &tm_spinlock_primitive[index];
+    tm_spinlock_start(1, tm_spinlock_uncontended_thread_entry, start);
+
+    tm_spinlock_primitive_ops[index] = tm_measure(TM_SPINLOCK_ID, tm_spinlock_counter_read);
+    tm_spinlock_primitive_cost[index] = tm_measure_cost(TM_SPINLOCK_ID);
+
+    tm_spinlock_primitive_status[index] =
+        tm_spinlock_status(tm_spinlock_stop_threads(1, start, TM_SPINLOCK_BATCH), tm_spinlock_primitive_ops[index]);
+}
+
+/* Measure the specified number of cores contending for the lock.  */
+static void tm_spinlock_contended(int threads)
+{
+    unsigned long long start[TM_SPINLOCK_MAX_THREADS];
+    unsigned long long delta;
+    unsigned long long sum;
+    unsigned long long squares;
+    int i;
+
+    tm_spinlock_start(threads, tm_spinlock_contended_thread_entry, start);
+
+    tm_spinlock_contended_ops[threads] = tm_measure(TM_SPINLOCK_ID, tm_spinlock_counter_read);
+
+    /* Compute Jain's fairness index of the acquisitions, in percent x100, scaled down to not overflow.  */
+    sum = 0;
+    squares = 0;
+    for (i = 0; i < threads; i++) {
+        delta = tm_counter_read(&tm_spinlock_counter[i]) - start[i];
+        sum += delta;
+        squares += delta * delta;
+    }
+    while (sum > 0xFFFFFF) {
+        sum >>= 1;
+        squares >>= 2;
+    }
+    tm_spinlock_contended_fairness[threads] =
+        (squares != 0) ? (unsigned long)(sum * sum / threads * 10000 / squares) : 0;
+
+    tm_spinlock_contended_status[threads] =
+        tm_spinlock_status(tm_spinlock_stop_threads(threads, start, 1), tm_spinlock_contended_ops[threads]);
+
+    /* Compute the average handoff latency, x100.  */
+    tm_spinlock_contended_handoff[threads] =
+        (tm_spinlock_handoffs != 0) ? tm_spinlock_handoff_total * 100 / tm_spinlock_handoffs : 0;
+    tm_spinlock_contended_handoff_max[threads] = tm_spinlock_handoff_max;
+}
+
+/* Define the spinlock test initialization.  */
+
+void tm_spinlock_initialize(void)
+{
+    unsigned int index;
+    int threads;
+
+    tm_spinlock_reason = RT_NULL;
+    tm_spinlock_cores = tm_cpu_count();
+    if (tm_spinlock_cores > TM_SPINLOCK_MAX_THREADS) {
+        tm_spinlock_cores = TM_SPINLOCK_MAX_THREADS;
+    }
+
+    for (index = 0; index < TM_SPINLOCK_PRIMITIVE_NUM; index++) {
+        tm_spinlock_uncontended(index);
+    }
+    for (threads = 2; threads <= tm_spinlock_cores; threads++) {
+        tm_spinlock_contended(threads);
+    }
+
+    tm_spinlock_thread_report();
+}
+
+/* Define the spinlock reporting function.  */
+void tm_spinlock_thread_report(void)
+{
+
+    unsigned long period_counter;
+    char label[48];
+    char handoff_buffer[16];
+    char fairness_buffer[16];
+    unsigned int periods;
+    unsigned int index;
+    int threads;
+
+    /* Total the critical sections of all variants.  */
+    period_counter = 0;
+    periods = 0;
+    for (index = 0; index < TM_SPINLOCK_PRIMITIVE_NUM; index++) {
+        period_counter += tm_spinlock_primitive_ops[index] * TM_SPINLOCK_BATCH;
+        periods++;
+    }
+    for (threads = 2; threads <= tm_spinlock_cores; threads++) {
+        period_counter += tm_spinlock_contended_ops[threads];
+        periods++;
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Spinlock thread died!\n");
+    }
+    if (tm_spinlock_reason != RT_NULL) {
+
+        tm_measure_fail(TM_SPINLOCK_ID, tm_spinlock_reason);
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Spinlock Test", period_counter,
+           TM_TEST_DURATION_VALUE * periods, rt_tick_get());
+    tm_measure_report_frequency();
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  uncontended", "sections", "counts/op", "");
+    for (index = 0; index < TM_SPINLOCK_PRIMITIVE_NUM; index++) {
+        printf("|   %-38s | %-10lu | %-10s | %-10s |\n", tm_spinlock_primitive[index].name,
+               tm_spinlock_primitive_ops[index] * TM_SPINLOCK_BATCH,
+               (tm_spinlock_primitive_status[index] == TM_SUCCESS) ?
+               tm_measure_format(handoff_buffer, sizeof(handoff_buffer),
+                                 tm_spinlock_primitive_cost[index] / TM_SPINLOCK_BATCH) :
+               "FAILED", "");
+    }
+    if (tm_spinlock_cores > 1) {
+        printf("| %-40s | %-10s | %-10s | %-10s |\n", "  contended", "sections", "handoff", "fairness %");
+    }
+    for (threads = 2; threads <= tm_spinlock_cores; threads++) {
+        snprintf(label, sizeof(label), "%d cores, max handoff %lu", threads,
+                 (unsigned long)tm_spinlock_contended_handoff_max[threads]);
+        printf("|   %-38s | %-10lu | %-10s | %-10s |\n", label, tm_spinlock_contended_ops[threads],
+               (tm_spinlock_contended_status[threads] == TM_SUCCESS) ?
+               tm_measure_format(handoff_buffer, sizeof(handoff_buffer), tm_spinlock_contended_handoff[threads]) :
+               "FAILED",
+               (tm_spinlock_contended_status[threads] == TM_SUCCESS) ?
+               tm_measure_format(fairness_buffer, sizeof(fairness_buffer), tm_spinlock_contended_fairness[threads]) :
+               "-");
+    }
+    tm_measure_report(TM_SPINLOCK_ID);
+
+    tm_teardown();
+}
@@ -43,7 +43,7 @@
 
 /* Define the counters used in the demo application...  */
 
-unsigned long tm_synchronization_processing_counter;
+TM_COUNTER tm_synchronization_processing_counter;
 
 /* Define the test thread prototypes.  */
 
@@ -104,33 +104,67 @@ void tm_synchronization_processing_thread_0_entry(void *p1, void *p2, void *p3)
         }
 
         /* Increment the number of semaphore get/puts.  */
-        tm_synchronization_processing_counter++;
+        tm_counter_increment(&tm_synchronization_processing_counter);
     }
 }
 
+/* Define the loop skeleton of the synchronization processing thread, with the RTOS services stubbed out.  */
+static TM_COUNTER tm_synchronization_skeleton_counter;
+
+static void tm_synchronization_processing_skeleton(unsigned long iterations)
+{
+    int status;
+
+    while (iterations--) {
+
+        /* Get the semaphore.  */
+        tm_calibration_stub(0, 0);
+
+        /* Release the semaphore.  */
+        status = tm_calibration_stub(0, 0);
+
+        /* Check for semaphore put error.  */
+        if (status != TM_SUCCESS) {
+            break;
+        }
+
+        /* Increment the number of semaphore get/puts.  */
+        tm_counter_increment(&tm_synchronization_skeleton_counter);
+    }
+}
+
+/* Define the synchronization processing test calibration function.  */
+void tm_synchronization_processing_calibrate(void)
+{
+    tm_calibrate(TM_SYNCHRONIZATION_PROCESSING_ID, tm_synchronization_processing_skeleton);
+}
+
+/* Define the synchronization processing counter read function.  */
+static unsigned long long tm_synchronization_processing_counter_read(void)
+{
+    return tm_counter_read(&tm_synchronization_processing_counter);
+}
+
 /* Define the synchronization test reporting function.  */
 void tm_synchronization_processing_thread_report(void)
 {
 
-    unsigned long last_counter;
+    unsigned long period_counter;
     unsigned long relative_time;
 
-    /* Initialize the last counter.  */
-    last_counter = 0;
-
     /* Initialize the relative time.  */
     relative_time = 0;
 
     while (1) {
 
-        /* Sleep to allow the test to run.  */
-        tm_thread_sleep(TM_TEST_DURATION_VALUE);
+        /* Measure the test for one period.  */
+        period_counter = tm_measure(TM_SYNCHRONIZATION_PROCESSING_ID, tm_synchronization_processing_counter_read);
 
         /* Increment the relative time.  */
         relative_time = relative_time + TM_TEST_DURATION_VALUE;
 
         /* See if there are any errors.  */
-        if (tm_synchronization_processing_counter == last_counter) {
+        if (period_counter == 0) {
 
             printf("ERROR: Invalid counter value(s). Error getting/putting "
                    "semaphore!\n");
@@ -140,11 +174,10 @@ void tm_synchronization_processing_thread_report(void)
         printf("+------------------------------------------+------------+------------+------------+\n"
                "| %-40s | %-10lu | %-10lu | %-10lu |\n",
                "Synchronization Processing Test",
-               tm_synchronization_processing_counter - last_counter, relative_time, rt_tick_get());
-        /* Save the last counter.  */
-        last_counter = tm_synchronization_processing_counter;
+               period_counter, relative_time, rt_tick_get());
+        tm_measure_report(TM_SYNCHRONIZATION_PROCESSING_ID);
 
-        tm_thread_detach();
+        tm_teardown();
         return;
     }
 }
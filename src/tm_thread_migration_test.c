@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2006-2025, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-17     RTT          the first version
+ */
+
+/*
+ * Thread migration test, for SMP builds with two cores or more. Two worker
+ * threads per core form a ring: each waits on its semaphore, runs the basic
+ * processing kernel over its own array and releases the semaphore of the
+ * next worker. One token per core circulates, so that every wakeup lets the
+ * scheduler place the woken worker. The ring runs for one test period with
+ * the workers bound round-robin to the cores, without affinity, and bound
+ * to the next core on every pass. Each worker counts the passes it starts
+ * on another core than the previous one. The report shows the passes and
+ * migrations of each placement and the extra timestamp counts per
+ * migration over the bound placement.
+ */
+
+#include "tm_api.h"
+
+#if defined(RT_USING_SMP)
+
+#define TM_MIGRATION_WORDS 256
+
+/* Define the maximum number of workers, at most the number of test threads.  */
+#define TM_MIGRATION_MAX_THREADS 8
+
+/* Define the placements of the workers.  */
+#define TM_MIGRATION_BOUND      0
+#define TM_MIGRATION_UNBOUND    1
+#define TM_MIGRATION_REBIND     2
+#define TM_MIGRATION_PLACEMENTS 3
+
+static const char *tm_migration_placement_name[TM_MIGRATION_PLACEMENTS] = {
+    "bound",
+    "no affinity",
+    "rebound every pass",
+};
+
+TM_COUNTER tm_thread_migration_counter[TM_MIGRATION_MAX_THREADS];
+TM_COUNTER tm_thread_migration_moves[TM_MIGRATION_MAX_THREADS];
+
+/* Define the semaphore of each worker and the array it works on.  */
+
+static struct rt_semaphore tm_migration_sem[TM_MIGRATION_MAX_THREADS];
+static unsigned long *tm_migration_data;
+
+/* Define the placement, the number of workers and of cores of the current variant.  */
+
+static volatile int tm_migration_placement;
+static int tm_migration_threads;
+static int tm_migration_cores;
+
+/* Define the results of each placement.  */
+static unsigned long tm_migration_ops[TM_MIGRATION_PLACEMENTS];
+static unsigned long long tm_migration_cost[TM_MIGRATION_PLACEMENTS];
+static unsigned long tm_migration_moves[TM_MIGRATION_PLACEMENTS];
+static int tm_migration_status[TM_MIGRATION_PLACEMENTS];
+
+/* Define the test thread prototypes.  */
+
+void tm_thread_migration_thread_entry(void *p1, void *p2, void *p3);
+
+/* Define the reporting function prototype.  */
+
+void tm_thread_migration_thread_report(void);
+
+/* Define the initialization prototype.  */
+
+void tm_thread_migration_initialize(void);
+
+/* Define main entry point.  */
+
+int tm_thread_migration_main(void)
+{
+    /* Initialize the test.  */
+    tm_initialize(tm_thread_migration_initialize);
+
+    return 0;
+}
+
+/* Define the worker threads.  */
+void tm_thread_migration_thread_entry(void *p1, void *p2, void *p3)
+{
+    int id = (int)(long)p1;
+    int placement = tm_migration_placement;
+    unsigned long *data = &tm_migration_data[id * TM_MIGRATION_WORDS];
+    unsigned long pass = 0;
+    int last = -1;
+    int cpu;
+
+    (void)p2;
+    (void)p3;
+
+    while (1) {
+
+        /* Wait for a token.  */
+        rt_sem_take(&tm_migration_sem[id], RT_WAITING_FOREVER);
+
+        /* Count the pass as a migration if it starts on another core than the previous one.  */
+        cpu = rt_hw_cpu_id();
+        if ((last >= 0) && (cpu != last)) {
+            tm_counter_increment(&tm_thread_migration_moves[id]);
+        }
+        last = cpu;
+
+        /* Run a pass of the kernel over the array of the worker.  */
+        tm_basic_processing_kernel(TM_BASIC_KERNEL, data, TM_MIGRATION_WORDS, pass++);
+
+        /* Move to the next core for the next pass.  */
+        if (placement == TM_MIGRATION_REBIND) {
+            tm_thread_bind(id, (cpu + 1) % tm_migration_cores);
+        }
+
+        /* Pass the token on and increment the passes of the worker.  */
+        rt_sem_release(&tm_migration_sem[(id + 1) % tm_migration_threads]);
+        tm_counter_increment(&tm_thread_migration_counter[id]);
+    }
+}
+
+/* Define the thread migration counter read function, the total of all workers.  */
+static unsigned long long tm_thread_migration_counter_read(void)
+{
+    unsigned long long total = 0;
+    int i;
+
+    for (i = 0; i < tm_migration_threads; i++) {
+        total += tm_counter_read(&tm_thread_migration_counter[i]);
+    }
+
+    return total;
+}
+
+/* Measure the ring with the workers placed as specified.  */
+static void tm_thread_migration_variant(int placement)
+{
+    unsigned long long moves[TM_MIGRATION_MAX_THREADS];
+    int i;
+
+    tm_migration_status[placement] = TM_ERROR;
+    tm_migration_placement = placement;
+
+    /* Give every other worker a token, one per core.  */
+    for (i = 0; i < tm_migration_threads; i++) {
+        rt_sem_init(&tm_migration_sem[i], "tm_mig", ((i & 1) == 0) ? 1 : 0, RT_IPC_FLAG_PRIO);
+    }
+
+    /* Create the workers at priority 10, bound round-robin to the cores unless without affinity.  */
+    for (i = 0; i < tm_migration_threads; i++) {
+        tm_thread_create(i, CONFIG_MAIN_THREAD_PRIORITY + 1, tm_thread_migration_thread_entry);
+        if (placement != TM_MIGRATION_UNBOUND) {
+            tm_thread_bind(i, i % tm_migration_cores);
+        }
+        moves[i] = tm_counter_read(&tm_thread_migration_moves[i]);
+    }
+    for (i = 0; i < tm_migration_threads; i++) {
+        tm_thread_resume(i);
+    }
+
+    /* Measure the passes for one period, then stop the workers.  */
+    tm_migration_ops[placement] = tm_measure(TM_THREAD_MIGRATION_ID, tm_thread_migration_counter_read);
+    tm_migration_cost[placement] = tm_measure_cost(TM_THREAD_MIGRATION_ID);
+    tm_migration_moves[placement] = 0;
+    for (i = 0; i < tm_migration_threads; i++) {
+        tm_migration_moves[placement] += (unsigned long)(tm_counter_read(&tm_thread_migration_moves[i]) - moves[i]);
+    }
+    tm_thread_detach_wait();
+    tm_migration_status[placement] = (tm_migration_ops[placement] != 0) ? TM_SUCCESS : TM_ERROR;
+    for (i = 0; i < tm_migration_threads; i++) {
+        rt_sem_detach(&tm_migration_sem[i]);
+    }
+}
+
+/* Define the thread migration test initialization.  */
+
+void tm_thread_migration_initialize(void)
+{
+    int placement;
+    int i;
+
+    /* Run two workers per core, on as many cores as there are workers for.  */
+    tm_migration_cores = tm_cpu_count();
+    if (tm_migration_cores > TM_MIGRATION_MAX_THREADS / 2) {
+        tm_migration_cores = TM_MIGRATION_MAX_THREADS / 2;
+    }
+    tm_migration_threads = 2 * tm_migration_cores;
+
+    tm_migration_data = (unsigned long *)rt_malloc_align(TM_MIGRATION_MAX_THREADS * TM_MIGRATION_WORDS *
+                                                         sizeof(unsigned long), TM_CACHE_LINE_SIZE);
+    for (placement = 0; (placement < TM_MIGRATION_PLACEMENTS) && (tm_migration_data != RT_NULL) &&
+                        (tm_migration_cores > 1); placement++) {
+        for (i = 0; i < tm_migration_threads; i++) {
+            tm_basic_processing_fill(&tm_migration_data[i * TM_MIGRATION_WORDS], TM_MIGRATION_WORDS);
+        }
+        tm_thread_migration_variant(placement);
+    }
+
+    tm_thread_migration_thread_report();
+
+    if (tm_migration_data != RT_NULL) {
+        rt_free_align(tm_migration_data);
+    }
+}
+
+/* Define the thread migration reporting function.  */
+void tm_thread_migration_thread_report(void)
+{
+
+    unsigned long period_counter;
+    unsigned long long extra;
+    char buffer[16];
+    int failed;
+    int placement;
+
+    /* Total the passes of all placements.  */
+    period_counter = 0;
+    failed = (tm_migration_cores < 2) || (tm_migration_data == RT_NULL);
+    for (placement = 0; placement < TM_MIGRATION_PLACEMENTS; placement++) {
+        period_counter += tm_migration_ops[placement];
+        failed |= (tm_migration_status[placement] != TM_SUCCESS);
+    }
+
+    /* See if there are any errors.  */
+    if (period_counter == 0) {
+
+        printf("ERROR: Invalid counter value(s). Thread migration thread died!\n");
+    }
+    if (failed) {
+
+        tm_measure_fail(TM_THREAD_MIGRATION_ID, (tm_migration_cores < 2) ? "needs two cores" :
+                       (tm_migration_data == RT_NULL) ? "out of memory" : "a ring stopped");
+    }
+
+    /* Show the time period total.  */
+    printf("| %-40s | %-10lu | %-10u | %-10lu |\n", "Thread Migration Test", period_counter,
+           TM_TEST_DURATION_VALUE * (unsigned int)TM_MIGRATION_PLACEMENTS, rt_tick_get());
+    printf("| %-40s | %-10s | %-10s | %-10s |\n", "  placement", "passes", "migrations", "counts/mig");
+    for (placement = 0; placement < TM_MIGRATION_PLACEMENTS; placement++) {
+
+        /* Charge the extra cost per pass over the bound placement to the migrations.  */
+        extra = 0;
+        if ((placement != TM_MIGRATION_BOUND) && (tm_migration_moves[placement] != 0) &&
+            (tm_migration_cost[placement] > tm_migration_cost[TM_MIGRATION_BOUND])) {
+            extra = (tm_migration_cost[placement] - tm_migration_cost[TM_MIGRATION_BOUND]) *
+                    tm_migration_ops[placement] / tm_migration_moves[placement];
+        }
+
+        printf("|   %-38s | %-10lu | %-10lu | %-10s |\n", tm_migration_placement_name[placement],
+               tm_migration_ops[placement], tm_migration_moves[placement],
+               (tm_migration_status[placement] != TM_SUCCESS) ? "FAILED" : ((extra != 0) ? tm_measure_format(buffer, sizeof(buffer), extra) : "-"));
+    }
+    tm_measure_report(TM_THREAD_MIGRATION_ID);
+
+    tm_teardown();
+}
+
+#else
+
+/* Define main entry point, the test needs an SMP build.  */
+
+int tm_thread_migration_main(void)
+{
+    return 0;
+}
+
+#endif